@@ -1,662 +1,2172 @@
-#pragma once
-#include <iostream>
-#include <sstream>
-#include <string>
-#include <vector>
-using namespace std;
-
-//=====================================================//
-//              AVLTree Class Header                   //
-//=====================================================//
-class AVLTree 
-{
-    private:
-
-        // TreeNode struct for storing data
-        struct TreeNode
-        {
-            string name;
-            string ufid;
-            int balanceFactor;
-            TreeNode* left;
-            TreeNode* right;
-            TreeNode() : name(""), ufid(""), balanceFactor(0), left(nullptr), right(nullptr) {};
-        };
-        
-        // Helper function to insert "node" into the AVLTree
-        TreeNode* insertHelper(TreeNode* node, string name, string ufid); 
-        
-        // Helper functions for print Traversals
-        void inorderHelper(TreeNode* node, vector<string>& vec);
-        void preorderHelper(TreeNode* node, vector<string>& vec);
-        void postorderHelper(TreeNode* node, vector<string>& vec);
-        
-        // Helper functions to search by name and id for a node in the AVLTree
-        void searchNameHelper(TreeNode* node, string name, vector<string>& ids);
-        TreeNode* searchIdHelper(TreeNode* node, string ufid);
-
-        // Helper function to remove "node" from the AVLTree
-        TreeNode* removeHelper(TreeNode* node, string ufid);
-
-        // Helper function to remove "n"th node in inorder traversal from AVLTree
-        TreeNode* removeInorderHelper(TreeNode* node, int n);
-
-    public:
-        
-        // Pointer for storing root node of tree  
-        TreeNode* root;                        
-
-        // Default constructor
-        AVLTree(){root = nullptr;};                                  
-
-        // Success strings
-        string success = "successful";         
-        string unsuccess = "unsuccessful";      
-
-        // Helper functions to determine height, balance factor, and smallest (leftmost) node of a tree
-        int height(TreeNode* node);             
-        int getBalanceFactor(TreeNode* node);   
-        TreeNode* minNode(TreeNode* node);
-
-        // Rotation functions
-        TreeNode* rotateLeft(TreeNode* node);   
-        TreeNode* rotateRight(TreeNode* node);
-        TreeNode* rotateLeftRight(TreeNode* node);
-        TreeNode* rotateRightLeft(TreeNode* node);
-
-        // Insert function
-        void insert(string name, string ufid);
-
-        // Print traversal functions 
-        void printInorder();
-        void printPreorder();
-        void printPostOrder();
-        void printLevelCount();
-
-        // Search functions
-        void searchName(string name);
-        void searchId(string ufid);
-
-        // Remove functions
-        void remove(string ufid);
-        void removeInorder(int n);
-
-        // vector for storing inorder traversal of all nodes in the tree (used for removeInorder)
-        vector<TreeNode*> inorderVec;
-
-        // helper function for populating "inorderVec" with the inorder traversal nodes (used for removeInorder)
-        void inorder(TreeNode* node);
-};
-
-
-//=====================================================//
-//   height, balanceFactor, minNode Helper Functions   //
-//=====================================================//
-
-// returns height of a subtree with node as its root node; O(log n)
-int AVLTree::height(TreeNode* node)
-{
-    if (node == nullptr)
-        return 0;
-    else
-    {
-        // recursively check height of left subtree then right subtree
-        int leftHeight = height(node->left);
-        int rightHeight = height(node->right);
-
-        return (max(leftHeight,rightHeight) + 1);
-    }
-}
-
-
-// checks balance factor of a given node; O(log n)
-int AVLTree::getBalanceFactor(TreeNode* node)
-{
-    // balance factor = height of nodes left subtree - height of nodes right subtree
-    int heightLeftSubTree = height(node->left);
-    int heightRightSubTree = height(node->right); 
-
-    return (heightLeftSubTree - heightRightSubTree);
-}
-
-
-// returns the minimum value node (smallest node) of a tree, used for removing a node with 2 children; O(log n)
-AVLTree::TreeNode* AVLTree::minNode(TreeNode* node)
-{
-    TreeNode* currNode = node;
-    
-    // traverse down leftmost path of the left subtree until nullptr is reached
-    while(currNode != nullptr && currNode->left != nullptr)
-    {
-        currNode = currNode->left;
-    }
-    return currNode;
-}
-
-
-//=====================================================//
-//              Rotation Function Definitions           //
-//=====================================================//
-
-// given tree with a right-right alignment, returns updated tree after a left rotation; O(1)
-AVLTree::TreeNode* AVLTree::rotateLeft(TreeNode* node)
-{
-    TreeNode* grandChild = node->right->left;
-    TreeNode* newParent = node->right;
-    newParent->left = node;
-    node->right = grandChild;
-    return newParent;
-}
-
-
-// given tree with a left-left alignment, returns updated tree after a right rotation; O(1)
-AVLTree::TreeNode* AVLTree::rotateRight(TreeNode* node)
-{
-    TreeNode* grandChild = node->left->right;
-    TreeNode* newParent = node->left;
-    newParent->right = node;
-    node->left = grandChild;
-    return newParent;
-}
-
-
-// given tree with a left-right alignment, returns updated tree after a left-right rotation; O(1)
-AVLTree::TreeNode* AVLTree::rotateLeftRight(TreeNode* node)
-{
-    node->left = rotateLeft(node->left);
-    return rotateRight(node);
-}
-
-
-// given tree with a right-left alignment, returns updated tree after a right-left rotation; O(1)
-AVLTree::TreeNode* AVLTree::rotateRightLeft(TreeNode* node)
-{
-    node->right = rotateRight(node->right);
-    return rotateLeft(node);
-}
-
-
-//=====================================================//
-//              Insert Function Definitions            //
-//=====================================================//
-
-// Helper function to insert "node" into the AVLTree (using recursion) ; O(log n)
-AVLTree::TreeNode* AVLTree::insertHelper(TreeNode* node, string name, string ufid)
-{
-
-    // if tree is empty, add new root
-    if (root == nullptr)
-    {
-        TreeNode* newRoot = new TreeNode();
-        newRoot->ufid = ufid;
-        newRoot->name = name;
-        root = newRoot;
-        cout << success << endl;
-        return newRoot;
-    }
-
-
-    // if node is empty, add new node
-    if (node == nullptr)
-    {
-        TreeNode* newNode = new TreeNode();
-        newNode->ufid = ufid;
-        newNode->name = name;
-        cout << success << endl;
-        return newNode;
-    }
-
-
-    // convert ufid we want to insert to an integer "key" for comparing with the ufid currently in the node
-    int key = stoi(ufid);
-
-    // Also convert current ufid to an integer for comparing with this previous "key"
-    int currId = stoi(node->ufid);
-
-    // check through node's children until a leaf is reached, and insert if unique 
-    if (key < currId)
-    {
-        // recursively insert into left subtree 
-        node->left = insertHelper(node->left, name, ufid);
-    }
-    else if (key > currId)
-    {
-        // recursively insert into right subtree 
-        node->right = insertHelper(node->right, name, ufid);
-    }
-    else
-    {
-        // else, duplicate "ufid" CANNOT INSERT, returns original node
-        cout << unsuccess << endl;
-        return node; 
-    }
-
-
-    // check the balance factor & perform rotations if necessary
-    node->balanceFactor = getBalanceFactor(node);
-    int balance = node->balanceFactor;
-
-
-    // rotate if necessary:
-
-    // Tree is RIGHT heavy
-    if (balance < -1)
-    {
-        if (key < stoi(node->right->ufid))
-        {
-            // Right-Left Alignment
-            return rotateRightLeft(node);           
-        }
-        else if (key > stoi(node->right->ufid))
-        {
-            // Right-Right Alignment
-            return rotateLeft(node);
-        }
-    }
-
-    // Tree is LEFT heavy
-    if (balance > 1)
-    {
-        if (key < stoi(node->left->ufid))
-        {
-            // Left-Left Alignment
-            return rotateRight(node);
-        }
-        else if (key > stoi(node->left->ufid))
-        {
-            // Left-Right Alignment
-            return rotateLeftRight(node);
-        }
-    }
-    return node;
-}
-
-
-// inserts the given name and id into the tree; O(log n)
-void AVLTree::insert(string name, string ufid) 
-{
-    this->root = insertHelper(this->root, name, ufid);
-}   
-
-
-//=====================================================//
-//           Traversal Function Definitions            //
-//=====================================================//
-
-// recursive helper function to preorder traverse (NLR) the tree and add the traversal to a vector; O(n)
-void AVLTree::preorderHelper(TreeNode* node, vector<string>& vec)
-{
-    if (node == nullptr)
-    {
-        return;
-    }
-    else
-    {
-        vec.push_back(node->name);          // N
-        preorderHelper(node->left, vec);    // L
-        preorderHelper(node->right, vec);   // R
-    }
-}
-
-
-// recursive helper function to inorder traverse (LNR) the tree and add the traversal to a vector; O(n)
-void AVLTree::inorderHelper(TreeNode* node, vector<string>& vec)
-{
-    if (node == nullptr)
-    {
-        return;
-    }
-    else
-    {
-        inorderHelper(node->left, vec);     // L
-        vec.push_back(node->name);          // N
-        inorderHelper(node->right, vec);    // R
-    }
-}
-
-
-// recursive helper function to postorder traverse (LRN) the tree and add the traversal to a vector; O(n)
-void AVLTree::postorderHelper(TreeNode* node, vector<string>& vec)
-{
-    if (node == nullptr)
-    {
-        return;
-    }
-    else
-    {
-        postorderHelper(node->left, vec);   // L
-        postorderHelper(node->right, vec);  // R
-        vec.push_back(node->name);          // N
-    }
-}
-
-
-// prints preorder traversal of the AVLTree; O(n)
-void AVLTree::printPreorder()
-{
-    if (root == nullptr)
-    {
-        return;
-    }
-
-    // create vector for storing preorder traversal & populate it by calling preorder helper function
-    vector<string> preVec;
-    preorderHelper(root, preVec);
-
-    // for each item in preVec (contains Preorder traversal), print it
-    for(int i = 0; i < preVec.size() - 1; i++)
-    {
-        cout << preVec[i] << ", ";
-    }
-    cout << preVec[preVec.size() - 1] << endl;
-}
-
-
-// prints inorder traversal of the AVLTree; O(n)
-void AVLTree::printInorder()
-{
-    if (root == nullptr)
-    {
-        return;
-    }
-
-    // create vector for storing inorder traversal & populate it by calling inorder helper function
-    vector<string> inVec;
-    inorderHelper(root, inVec);
-
-    // for each item in inVec (contains Inorder traversal), print it
-    for(int i = 0; i < inVec.size() - 1; i++)
-    {
-        cout << inVec[i] << ", ";
-    }
-    cout << inVec[inVec.size() - 1] << endl;
-}
-
-
-// prints postorder traversal of the AVLTree; O(n)
-void AVLTree::printPostOrder()
-{
-    if (root == nullptr)
-    {
-        return;
-    }
-    
-    // create vector for storing postorder traversal & populate it by calling postorder helper function
-    vector<string> postVec;
-    postorderHelper(root, postVec);
-
-    // for each item in postVec (contains Postorder traversal), print it
-    for(int i = 0; i < postVec.size() - 1; i++)
-    {
-        cout << postVec[i] << ", ";
-    }
-    cout << postVec[postVec.size() - 1] << endl;
-}
-
-
-// prints number of levels that exist in the tree; O(log n)
-void AVLTree::printLevelCount()
-{
-    int levelCount;
-
-    // if tree is empty, levelCount = 0
-    if (root == nullptr)
-    {
-        levelCount = 0;
-        cout << levelCount << endl;
-    }
-    // Else, levelCount = height of the root node
-    else
-    {
-        levelCount = height(root);
-        cout << levelCount << endl;
-    }
-}
-
-
-//=====================================================//
-//           Search Function Definitions               //
-//=====================================================//
-
-// Helper function using preorder traversal to search for "node" in the AVLTree w/ specified "name"; O(n)
-void AVLTree::searchNameHelper(TreeNode* node, string name, vector<string>& ids)
-{
-    // if node to search for is empty, return nullptr
-    if (node == nullptr)
-    {
-        return;
-    }
-
-    // else, recursively preorder traverse (NLR) through the tree until it is found
-        
-    // if node is found, return it (N)
-    if (node->name == name)
-    {
-        ids.push_back(node->ufid);
-    }
-
-    // recursively check left subtree (L)
-    searchNameHelper(node->left, name, ids);
-
-    // recursively check right subtree (R)
-    searchNameHelper(node->right, name, ids);
-}
-
-
-// Searches for "name" in the tree; O(n)
-void AVLTree::searchName(string name)
-{
-    // create vector for storing preorder traversal of found names, and call to searchName helper to populate it
-    vector<string> preorderAns;
-    searchNameHelper(root, name, preorderAns);
-
-    //if found prints associated "ufid", otherwise prints "unsuccessful"
-    if(preorderAns.size() == 0)
-    {
-        // name was not found
-        cout << unsuccess << endl;
-    }
-    else
-    {
-        // name was found, print the associated ufid
-        for (int i = 0; i < preorderAns.size(); i++)
-        {
-            cout << preorderAns[i] << endl;
-        }
-    }
-}
-
-
-// Helper function uses recursion to search for "node" in the AVLTree w/ specified "ufid" ; O(log n)
-AVLTree::TreeNode* AVLTree::searchIdHelper(TreeNode* node, string ufid)
-{
-    // if node to search for is empty, return nullptr
-    if (node == nullptr)
-    {
-        return nullptr;
-    }
-
-    // if node is found, return it
-    if (node->ufid == ufid)
-    {
-        return node;
-    }
-
-    // else, recursively check through the nodes children until it is found, else return nullptr
-    int key = stoi(ufid);
-
-    // recursively search through left subtree
-    if (key < stoi(node->ufid))
-    {
-        return searchIdHelper(node->left, ufid);
-    }
-    // recursively search through right subtree
-    else if (key > stoi(node->ufid))
-    {
-        return searchIdHelper(node->right, ufid);
-    }
-
-    // return nullptr if ufid cant be found
-    return nullptr;
-}
-
-
-// Searches for "ufid" in the tree; O(log n)
-void AVLTree::searchId(string ufid)
-{
-    TreeNode* foundNode = searchIdHelper(root, ufid);
-    
-    // if found prints associated "name", otherwise prints "unsuccessful"
-    if(foundNode == nullptr)
-    {
-        // name was not found
-        cout << unsuccess << endl;
-    }
-    else
-    {
-        // name was found, print the associated name
-        cout << foundNode->name << endl;
-    }
-}
-
-
-//=====================================================//
-//           Remove Function Definitions               //
-//=====================================================//
-
-// Helper function to remove "node" from the AVLTree; O(log n)
-AVLTree::TreeNode* AVLTree::removeHelper(TreeNode* node, string ufid)
-{
-    if (node == nullptr)
-    {
-        // node is not in tree
-        return nullptr; 
-    }
-
-    // variables to compare the passed in ufid to remove and the current ufid in the node
-    int key = stoi(ufid);
-    int currId = stoi(node->ufid);
-
-    if (key < currId)
-    {
-        // return result of deleting from left subtree
-        node->left = removeHelper(node->left, ufid);
-    }
-    else if (key > currId)
-    {
-        // return result of deleting from right subtree
-        node->right = removeHelper(node->right, ufid);
-    }
-    else
-    {
-        // item is found, store local root in "tempNode"
-
-        // if local root has no children, 
-        if (node->left == nullptr && node->right == nullptr)
-        {
-            // set parent of local root to nullptr
-            node = nullptr;
-            return node;
-        }
-
-        // local root has 1 right child
-        else if (node->left == nullptr)
-        {
-            // set parent of local root to reference that child
-            TreeNode* tempNode = node->right;
-            delete node;
-            return tempNode;
-        }
-
-        // local root has 1 left child
-        else if (node->right == nullptr)
-        {
-            // set parent of local root to reference that child
-            TreeNode* tempNode = node->left;
-            delete node;
-            return tempNode;
-        }
-
-        // local root has 2 children
-        else
-        {
-            // find inorder successor to replace removed node; inorder successor = minimum node of right subtree
-            TreeNode* tempNode = minNode(node->right);
-
-            // copy its data into local roots data 
-            node->name = tempNode->name;
-            node->ufid = tempNode->ufid;
-
-            // remove the inorder successor
-            node->right = removeHelper(node->right, tempNode->ufid);
-        }
-    }
-    return node;
-}
-
-
-// removes node with given "ufid" from the tree, if it exists; O(log n)
-void AVLTree::remove(string ufid)
-{
-    this->root = removeHelper(this->root, ufid);
-
-    if (removeHelper(this->root,ufid) != nullptr)
-    {
-        cout << success << endl;
-    }
-    else
-    {
-        cout << unsuccess << endl;
-    }
-}
-
-
-// fills "inorderVec" with the inorder traversal (LNR) of the nodes in the tree; O(n)
-void AVLTree::inorder(TreeNode* node)
-{
-    if (node == nullptr)
-    {
-        return;
-    }
-    else
-    {
-        inorder(node->left);          // L
-        inorderVec.push_back(node);   // N
-        inorder(node->right);         // R
-    }
-}
-
-
-// Helper function to remove "n"th node in inorder traversal from AVLTree; O(n)
-AVLTree::TreeNode* AVLTree::removeInorderHelper(TreeNode* node, int n)
-{
-    // if node is empty, return nullptr
-    if (node == nullptr)
-    {
-        return nullptr;
-    }
-
-    // fill "inorderVec" with the inorder traversal of all nodes in the AVLTree
-    inorder(root);
-
-    if (n >= inorderVec.size())
-    {
-        // n is larger than the number of nodes in the tree, and so the node does not exist
-        cout << unsuccess << endl;
-        return node;
-    }
-
-    // create variable of the node to be removed by calling the n'th node in "inorderVec"
-    TreeNode* nodeToRemove = inorderVec[n];
-    
-    // return the result of removing this node
-    cout << success << endl;
-    return removeHelper(root, nodeToRemove->ufid);
-}
-
-
-// removes the n'th ufid in the inorder traversal of the tree; O(n)
-void AVLTree::removeInorder(int n)
-{
-    removeInorderHelper(root, n);
-}
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Generator.h"
+#include "HotCache.h"
+#include "IdFilter.h"
+#include "IdHashIndex.h"
+#include "InputValidation.h"
+#include "NameIndex.h"
+#include "ParallelAlgorithms.h"
+#include "TreeStats.h"
+#include "WorkStealingPool.h"
+#include "WriteAheadLog.h"
+using namespace std;
+
+//=====================================================//
+//              AVLTree Class Header                   //
+//=====================================================//
+class AVLTree 
+{
+    private:
+
+        // TreeNode struct for storing data; "key" caches ufidKey(ufid) and "height" the subtree height so neither is recomputed per level
+        // ("deleted" marks a tombstone: a removed student whose node stays linked until the next compaction, see enableTombstones)
+        struct TreeNode
+        {
+            string name;
+            string ufid;
+            int key;
+            int height;
+            int balanceFactor;
+            bool deleted;
+            TreeNode* left;
+            TreeNode* right;
+            TreeNode* parent;
+            TreeNode() : name(""), ufid(""), key(0), height(1), balanceFactor(0), deleted(false), left(nullptr), right(nullptr), parent(nullptr) {};
+        };
+        
+        // Helper function to insert a new node into the AVLTree, returns the new node or nullptr for a duplicate ufid
+        TreeNode* insertHelper(string name, string ufid); 
+
+        // Helper functions to refresh a node's stored height / balance factor, and to hang "newChild" where "oldChild" was under "parent"
+        void updateHeight(TreeNode* node);
+        void replaceChild(TreeNode* parent, TreeNode* oldChild, TreeNode* newChild);
+
+        // Helper function to rotate an unbalanced "node" back into AVL shape, returns the new root of its subtree
+        TreeNode* rebalance(TreeNode* node);
+
+        // Helper function to walk from "node" up to the root fixing heights and balance, stopping once heights stop changing
+        void retrace(TreeNode* node);
+        
+        // Helper functions walking the subtree of "node" in order without allocating (recursion depth is bounded by the
+        // AVL height), calling visit(node) on every live node until it returns false; each returns false if cut short
+        template <typename Visitor>
+        bool walkInorder(TreeNode* node, Visitor& visit);
+        template <typename Visitor>
+        bool walkPreorder(TreeNode* node, Visitor& visit);
+        template <typename Visitor>
+        bool walkPostorder(TreeNode* node, Visitor& visit);
+
+        // one in-order slice of a parallel export: a lone node above the cutoff depth, or a whole subtree at it, with its
+        // names rendered into "text" ("count" of them, so an empty name still gets its separator)
+        struct ExportPiece
+        {
+            TreeNode* node;
+            bool wholeSubtree;
+            string text;
+            size_t count;
+        };
+
+        // Helper functions for exportInorder: cut the tree into in-order pieces "cutoff" levels down, and render one piece
+        void collectExportPieces(TreeNode* node, int depth, int cutoff, vector<ExportPiece>& pieces);
+        void renderExportPiece(ExportPiece& piece);
+        
+        // Helper function to search by id for a node in the AVLTree
+        TreeNode* searchIdHelper(TreeNode* node, string ufid);
+
+        // Helper function to collect the nodes with keys in [low, high] in inorder, skipping subtrees outside the range
+        void searchRangeHelper(TreeNode* node, int low, int high, vector<TreeNode*>& found);
+
+        // Helper function to find the node holding the key of "ufid" below "node" (tombstones included), nullptr if there is none
+        TreeNode* locateKey(TreeNode* node, string ufid);
+
+        // Helper function to find the node with "ufid" below "node" and remove it in one descent, returns whether it was found
+        bool removeHelper(TreeNode* node, string ufid);
+
+        // Helper function to unlink an already located node from the AVLTree and retrace from its parent
+        void removeNode(TreeNode* node);
+
+        // Helper function to remove a located node: tombstones it in tombstone mode, otherwise unlinks it; false if already a tombstone
+        bool retireNode(TreeNode* node);
+
+        // Helper function to relink "nodes" (sorted by key) into a perfectly balanced subtree under "parent", returns its root
+        TreeNode* buildBalanced(vector<TreeNode*>& nodes, int low, int high, TreeNode* parent);
+
+        // Helper function for the bulk constructor: links the top "depth" levels of buildBalanced itself and hands every
+        // subtree below them to "pool" (the caller waits for the pool before using the tree)
+        TreeNode* buildBalancedParallel(vector<TreeNode*>& nodes, int low, int high, TreeNode* parent, int depth, WorkStealingPool& pool);
+
+        // Helper function to remove "n"th node in inorder traversal from AVLTree
+        TreeNode* removeInorderHelper(TreeNode* node, int n);
+
+        // sorted index of names kept in sync with every insert and remove (used for prefix / case-insensitive search)
+        NameIndex nameIndex;
+
+        // optional Bloom filter over ufids consulted before searchId / remove descend (see enableIdFilter)
+        IdFilter idFilter;
+        bool idFilterEnabled = false;
+        size_t idFilterStale = 0;
+
+        // optional direct-mapped cache of recently searched ufids -> nodes (see enableIdCache)
+        HotCache<TreeNode*> idCache;
+
+        // optional hash table from ufid to node giving O(1) point lookups next to the ordered tree (see enableIdHash)
+        IdHashIndex<TreeNode*> idHash;
+        bool idHashEnabled = false;
+
+        // optional write-ahead log of successful updates, and the snapshot that checkpoints it (see enableWal)
+        WriteAheadLog wal;
+        string walSnapshotPath;
+
+        // operation counters: inserts, duplicates, removes, rotations by type, searches and nodes visited (see stats)
+        TreeStats treeStats;
+
+        // optional lazy deletion: removed nodes stay linked as tombstones until they exceed "compactionThreshold" of the tree
+        bool tombstonesEnabled = false;
+        double compactionThreshold = 0.25;
+        size_t tombstones = 0;
+
+        // Helper functions to add / drop a node's data in the secondary indexes (bulk loads fill the name index separately)
+        void indexNode(TreeNode* node, bool withName = true);
+        void unindexNode(TreeNode* node);
+
+        // Helper functions to refill the ufid filter from the tree, and to do so once removed ufids pile up
+        void rebuildIdFilter(size_t expectedCount);
+        void maybeRebuildIdFilter();
+
+    public:
+        
+        // Pointer for storing root node of tree  
+        TreeNode* root;                        
+
+        // Default constructor
+        AVLTree(){root = nullptr;};                                  
+
+        // Bulk constructor: builds a perfectly balanced tree from unsorted (name, ufid) pairs on "threads" workers (0 = one per
+        // core) by sorting the keys, dropping the rows the insert command rejects and repeated ufids (the first occurrence
+        // wins, as with inserts) and linking the subtrees in parallel; prints nothing; O(n log n) work, O(n log n / threads + n) span
+        explicit AVLTree(vector<pair<string, string>> students, unsigned threads = 0);
+
+        // Destructor frees every node; trees own their nodes, so they cannot be copied
+        ~AVLTree(){clear();};
+        AVLTree(const AVLTree&) = delete;
+        AVLTree& operator=(const AVLTree&) = delete;
+
+        // removes every node from the tree and empties the secondary indexes; O(n)
+        void clear();
+
+        // Success strings
+        string success = "successful";         
+        string unsuccess = "unsuccessful";      
+
+        // Helper functions to determine height, balance factor, and smallest (leftmost) node of a tree
+        int height(TreeNode* node);             
+        int getBalanceFactor(TreeNode* node);   
+        TreeNode* minNode(TreeNode* node);
+
+        // Rotation functions
+        TreeNode* rotateLeft(TreeNode* node);   
+        TreeNode* rotateRight(TreeNode* node);
+        TreeNode* rotateLeftRight(TreeNode* node);
+        TreeNode* rotateRightLeft(TreeNode* node);
+
+        // Insert function
+        void insert(string name, string ufid);
+
+        // read-only view of one student handed to traversal visitors; it refers to the node's own strings, so it is only
+        // valid during the visit
+        struct NodeView
+        {
+            const string& ufid;
+            const string& name;
+            int key;
+        };
+
+        // Visitor traversal functions: call visit(const NodeView&) on every student in that order, stopping as soon as
+        // it returns false; return true if the walk reached the end; O(n)
+        template <typename Visitor>
+        bool forEachInorder(Visitor visit);
+        template <typename Visitor>
+        bool forEachPreorder(Visitor visit);
+        template <typename Visitor>
+        bool forEachPostorder(Visitor visit);
+
+#if defined(__cpp_impl_coroutine)
+        // Generator traversal functions (C++20 only): lazily yield a view of every student in that order, doing one step
+        // of an explicit stack walk per value, so a caller can stop after k students or interleave several walks; the tree
+        // must not change while a generator is in use; O(1) amortized per value, O(log n) frame
+        Generator<NodeView> generateInorder();
+        Generator<NodeView> generatePreorder();
+        Generator<NodeView> generatePostorder();
+#endif
+
+        // Print traversal functions 
+        void printInorder();
+        void printPreorder();
+        void printPostOrder();
+        void printLevelCount();
+
+        // Parallel export: writes exactly what printInorder prints to "out", rendering subtrees into separate buffers on
+        // "threads" work-stealing workers (0 = one per core) and writing the buffers in order; O(n / threads + log n) span
+        void exportInorder(ostream& out, unsigned threads = 0);
+
+        // Search functions
+        void searchName(string name);
+        void searchId(string ufid);
+        void searchNamePrefix(string prefix, int limit = -1);
+        void searchNameIgnoreCase(string name);
+        void searchRange(string lowUfid, string highUfid);
+
+        // ufid filter functions: turn the Bloom filter on (sized for "expectedCount" ufids) or off, and read its counters
+        void enableIdFilter(size_t expectedCount = 1024);
+        void disableIdFilter();
+        IdFilter::Stats idFilterStats();
+
+        // hot ufid cache functions: turn the searchId cache on (with "slotCount" slots) or off, and read its counters
+        void enableIdCache(size_t slotCount = 4096);
+        void disableIdCache();
+        HotCache<TreeNode*>::Stats idCacheStats();
+
+        // hybrid hash mode functions: index every ufid in a hash table for O(1) searchId / remove lookups, or stop doing so
+        void enableIdHash();
+        void disableIdHash();
+
+        // Remove functions
+        void remove(string ufid);
+        void removeInorder(int n);
+
+        // vector for storing inorder traversal of all nodes in the tree (used for removeInorder)
+        vector<TreeNode*> inorderVec;
+
+        // helper function for populating "inorderVec" with the inorder traversal nodes (used for removeInorder)
+        void inorder(TreeNode* node);
+
+        // Snapshot functions: write the tree to / rebuild it from a compact binary file, returning false on I/O or format errors
+        // (a failed load leaves the tree as it was; while the write-ahead log is on, a successful one checkpoints the tree)
+        bool saveSnapshot(string path);
+        bool loadSnapshot(string path);
+
+        // Durability functions: recover from "snapshotPath" + the log at "logPath" and log every later update (fsyncs are
+        // batched per "groupCommitMicros" window); checkpoint folds the log into the snapshot; disableWal syncs and stops logging
+        bool enableWal(string logPath, string snapshotPath, int groupCommitMicros = 1000);
+        bool checkpoint();
+        void disableWal();
+
+        // Statistics functions: copy the operation counters, print them one "name value" pair per line, or zero them
+        TreeStats::Snapshot stats();
+        void printStats();
+        void resetStats();
+
+        // shape and memory report of the tree (see analyze)
+        struct Analysis
+        {
+            size_t nodeCount = 0;               // linked nodes, tombstones included
+            size_t tombstones = 0;
+            int height = 0;
+            int optimalHeight = 0;              // ceil(log2(n + 1)): the height of a perfectly balanced tree of n nodes
+            double averageDepth = 0;            // mean nodes visited by a successful searchId
+            int maxDepth = 0;
+            size_t balanceCounts[3] = {};       // nodes whose balance factor is -1, 0, +1
+            size_t unbalancedNodes = 0;         // nodes outside -1 .. +1 (always 0 unless the tree is corrupt)
+            size_t nodeBytes = 0;               // heap bytes of the TreeNode allocations
+            size_t stringBytes = 0;             // heap bytes of names / ufids too long to live inside their TreeNode
+            size_t heapInUse = 0;               // malloc arena bytes in use, for the whole process
+            size_t heapFree = 0;                // malloc arena bytes free but not returned to the system
+            size_t heapMapped = 0;              // bytes of large blocks malloc mapped separately
+            double fragmentation = 0;           // heapFree / (heapInUse + heapFree)
+        };
+
+        // Analysis functions: measure the tree in one O(n) pass with an explicit stack, or print that report "name value" per line
+        Analysis analyze();
+        void printAnalysis();
+
+        // Tombstone functions: make remove mark nodes instead of unlinking them (compacting once tombstones pass
+        // "threshold" of all nodes), go back to unlinking (compacting first), rebuild without tombstones now, and count them
+        void enableTombstones(double threshold = 0.25);
+        void disableTombstones();
+        void compact();
+        size_t tombstoneCount() { return tombstones; }
+};
+
+
+//=====================================================//
+//   height, balanceFactor, minNode Helper Functions   //
+//=====================================================//
+
+// returns height of a subtree with node as its root node (stored in the node); O(1)
+int AVLTree::height(TreeNode* node)
+{
+    if (node == nullptr)
+        return 0;
+    else
+        return node->height;
+}
+
+
+// checks balance factor of a given node; O(1)
+int AVLTree::getBalanceFactor(TreeNode* node)
+{
+    // balance factor = height of nodes left subtree - height of nodes right subtree
+    int heightLeftSubTree = height(node->left);
+    int heightRightSubTree = height(node->right); 
+
+    return (heightLeftSubTree - heightRightSubTree);
+}
+
+
+// returns the minimum value node (smallest node) of a tree, used for removing a node with 2 children; O(log n)
+AVLTree::TreeNode* AVLTree::minNode(TreeNode* node)
+{
+    TreeNode* currNode = node;
+    
+    // traverse down leftmost path of the left subtree until nullptr is reached
+    while(currNode != nullptr && currNode->left != nullptr)
+    {
+        currNode = currNode->left;
+    }
+    return currNode;
+}
+
+
+// recomputes the stored height and balance factor of "node" from its children; O(1)
+void AVLTree::updateHeight(TreeNode* node)
+{
+    int leftHeight = height(node->left);
+    int rightHeight = height(node->right);
+    node->height = max(leftHeight, rightHeight) + 1;
+    node->balanceFactor = leftHeight - rightHeight;
+}
+
+
+// links "newChild" into the slot of "parent" that held "oldChild" (or makes it the root); O(1)
+void AVLTree::replaceChild(TreeNode* parent, TreeNode* oldChild, TreeNode* newChild)
+{
+    if (parent == nullptr)
+        root = newChild;
+    else if (parent->left == oldChild)
+        parent->left = newChild;
+    else
+        parent->right = newChild;
+
+    if (newChild != nullptr)
+        newChild->parent = parent;
+}
+
+
+//=====================================================//
+//              Rotation Function Definitions           //
+//=====================================================//
+
+// given tree with a right-right alignment, returns updated tree after a left rotation; O(1)
+// (the returned subtree root keeps node's old parent pointer; the caller links it into that parent)
+AVLTree::TreeNode* AVLTree::rotateLeft(TreeNode* node)
+{
+    TreeNode* grandChild = node->right->left;
+    TreeNode* newParent = node->right;
+    newParent->left = node;
+    node->right = grandChild;
+
+    // fix parent pointers of the three nodes that moved
+    if (grandChild != nullptr)
+        grandChild->parent = node;
+    newParent->parent = node->parent;
+    node->parent = newParent;
+
+    // node is now below newParent, so its height must be refreshed first
+    updateHeight(node);
+    updateHeight(newParent);
+    return newParent;
+}
+
+
+// given tree with a left-left alignment, returns updated tree after a right rotation; O(1)
+// (the returned subtree root keeps node's old parent pointer; the caller links it into that parent)
+AVLTree::TreeNode* AVLTree::rotateRight(TreeNode* node)
+{
+    TreeNode* grandChild = node->left->right;
+    TreeNode* newParent = node->left;
+    newParent->right = node;
+    node->left = grandChild;
+
+    // fix parent pointers of the three nodes that moved
+    if (grandChild != nullptr)
+        grandChild->parent = node;
+    newParent->parent = node->parent;
+    node->parent = newParent;
+
+    // node is now below newParent, so its height must be refreshed first
+    updateHeight(node);
+    updateHeight(newParent);
+    return newParent;
+}
+
+
+// given tree with a left-right alignment, returns updated tree after a left-right rotation; O(1)
+AVLTree::TreeNode* AVLTree::rotateLeftRight(TreeNode* node)
+{
+    node->left = rotateLeft(node->left);
+    return rotateRight(node);
+}
+
+
+// given tree with a right-left alignment, returns updated tree after a right-left rotation; O(1)
+AVLTree::TreeNode* AVLTree::rotateRightLeft(TreeNode* node)
+{
+    node->right = rotateRight(node->right);
+    return rotateLeft(node);
+}
+
+
+// picks the rotation for an unbalanced "node" from its heavy child's balance and links the result into node's parent; O(1)
+AVLTree::TreeNode* AVLTree::rebalance(TreeNode* node)
+{
+    TreeNode* parent = node->parent;
+    TreeNode* newRoot;
+
+    // Tree is LEFT heavy
+    if (node->balanceFactor > 1)
+    {
+        if (getBalanceFactor(node->left) >= 0)
+        {
+            // Left-Left Alignment
+            newRoot = rotateRight(node);
+            treeStats.add(TreeStats::RotateRight);
+        }
+        else
+        {
+            // Left-Right Alignment
+            newRoot = rotateLeftRight(node);
+            treeStats.add(TreeStats::RotateLeftRight);
+        }
+    }
+    // Tree is RIGHT heavy
+    else
+    {
+        if (getBalanceFactor(node->right) <= 0)
+        {
+            // Right-Right Alignment
+            newRoot = rotateLeft(node);
+            treeStats.add(TreeStats::RotateLeft);
+        }
+        else
+        {
+            // Right-Left Alignment
+            newRoot = rotateRightLeft(node);
+            treeStats.add(TreeStats::RotateRightLeft);
+        }
+    }
+
+    replaceChild(parent, node, newRoot);
+    return newRoot;
+}
+
+
+// walks parent pointers from "node" to the root, refreshing heights and rotating where needed; O(log n)
+// stops as soon as a subtree's height comes out unchanged, since no ancestor above it can have changed either
+void AVLTree::retrace(TreeNode* node)
+{
+    while (node != nullptr)
+    {
+        int oldHeight = node->height;
+        updateHeight(node);
+
+        // rotate if necessary, continuing from the new root of this subtree
+        if (node->balanceFactor > 1 || node->balanceFactor < -1)
+        {
+            node = rebalance(node);
+        }
+
+        if (node->height == oldHeight)
+        {
+            return;
+        }
+        node = node->parent;
+    }
+}
+
+
+//=====================================================//
+//              Insert Function Definitions            //
+//=====================================================//
+
+// Helper function to insert a new node into the AVLTree (iterative descent, then bottom-up retrace) ; O(log n)
+AVLTree::TreeNode* AVLTree::insertHelper(string name, string ufid)
+{
+    // convert ufid we want to insert to an integer "key" once, for comparing with the keys stored in the nodes
+    int key = ufidKey(ufid);
+
+    // walk down from the root to the empty slot where the key belongs, rejecting a duplicate on the way
+    TreeNode* parent = nullptr;
+    TreeNode* currNode = root;
+    while (currNode != nullptr)
+    {
+        parent = currNode;
+        if (key < currNode->key)
+        {
+            currNode = currNode->left;
+        }
+        else if (key > currNode->key)
+        {
+            currNode = currNode->right;
+        }
+        else if (currNode->deleted)
+        {
+            // the ufid belongs to a tombstone, so bring that node back to life with the new data
+            currNode->name = name;
+            currNode->ufid = ufid;
+            currNode->deleted = false;
+            tombstones--;
+            indexNode(currNode);
+            treeStats.add(TreeStats::Inserts);
+            return currNode;
+        }
+        else
+        {
+            // duplicate "ufid" CANNOT INSERT
+            treeStats.add(TreeStats::DuplicateInserts);
+            return nullptr;
+        }
+    }
+
+    // add the new node as a leaf (or as the new root if the tree is empty)
+    TreeNode* newNode = new TreeNode();
+    newNode->ufid = ufid;
+    newNode->name = name;
+    newNode->key = key;
+    newNode->parent = parent;
+    if (parent == nullptr)
+        root = newNode;
+    else if (key < parent->key)
+        parent->left = newNode;
+    else
+        parent->right = newNode;
+
+    indexNode(newNode);
+    treeStats.add(TreeStats::Inserts);
+
+    // fix heights on the way back up, rotating at most once
+    retrace(parent);
+    return newNode;
+}
+
+
+// inserts the given name and id into the tree; O(log n)
+void AVLTree::insert(string name, string ufid) 
+{
+    TreeNode* inserted = insertHelper(name, ufid);
+    if (inserted == nullptr)
+    {
+        cout << unsuccess << endl;
+        return;
+    }
+
+    // log the insert before acknowledging it; if the log cannot record it, take the student back out
+    if (wal.isOpen() && !wal.append(WriteAheadLog::Insert, ufid, name))
+    {
+        retireNode(inserted);
+        maybeRebuildIdFilter();
+        cout << unsuccess << endl;
+        return;
+    }
+    cout << success << endl;
+}   
+
+
+//=====================================================//
+//           Traversal Function Definitions            //
+//=====================================================//
+
+// recursive helper to inorder traverse (LNR) the subtree of "node", stopping once visit returns false; O(n)
+template <typename Visitor>
+bool AVLTree::walkInorder(TreeNode* node, Visitor& visit)
+{
+    if (node == nullptr)
+    {
+        return true;
+    }
+    return walkInorder(node->left, visit)           // L
+        && (node->deleted || visit(node))           // N
+        && walkInorder(node->right, visit);         // R
+}
+
+
+// recursive helper to preorder traverse (NLR) the subtree of "node", stopping once visit returns false; O(n)
+template <typename Visitor>
+bool AVLTree::walkPreorder(TreeNode* node, Visitor& visit)
+{
+    if (node == nullptr)
+    {
+        return true;
+    }
+    return (node->deleted || visit(node))           // N
+        && walkPreorder(node->left, visit)          // L
+        && walkPreorder(node->right, visit);        // R
+}
+
+
+// recursive helper to postorder traverse (LRN) the subtree of "node", stopping once visit returns false; O(n)
+template <typename Visitor>
+bool AVLTree::walkPostorder(TreeNode* node, Visitor& visit)
+{
+    if (node == nullptr)
+    {
+        return true;
+    }
+    return walkPostorder(node->left, visit)         // L
+        && walkPostorder(node->right, visit)        // R
+        && (node->deleted || visit(node));          // N
+}
+
+
+// calls visit with a view of every live student in inorder (ascending ufid); O(n)
+template <typename Visitor>
+bool AVLTree::forEachInorder(Visitor visit)
+{
+    auto viewOf = [&visit](TreeNode* node) { return (bool)visit(NodeView{node->ufid, node->name, node->key}); };
+    return walkInorder(root, viewOf);
+}
+
+
+// calls visit with a view of every live student in preorder; O(n)
+template <typename Visitor>
+bool AVLTree::forEachPreorder(Visitor visit)
+{
+    auto viewOf = [&visit](TreeNode* node) { return (bool)visit(NodeView{node->ufid, node->name, node->key}); };
+    return walkPreorder(root, viewOf);
+}
+
+
+// calls visit with a view of every live student in postorder; O(n)
+template <typename Visitor>
+bool AVLTree::forEachPostorder(Visitor visit)
+{
+    auto viewOf = [&visit](TreeNode* node) { return (bool)visit(NodeView{node->ufid, node->name, node->key}); };
+    return walkPostorder(root, viewOf);
+}
+
+
+#if defined(__cpp_impl_coroutine)
+// yields every live student in inorder (ascending ufid): descend left pushing each node, yield, then go right; O(n)
+Generator<AVLTree::NodeView> AVLTree::generateInorder()
+{
+    vector<TreeNode*> stack;
+    TreeNode* node = root;
+    while (node != nullptr || !stack.empty())
+    {
+        while (node != nullptr)
+        {
+            stack.push_back(node);
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        if (!node->deleted)
+        {
+            co_yield NodeView{node->ufid, node->name, node->key};
+        }
+        node = node->right;
+    }
+}
+
+
+// yields every live student in preorder: pop a node, yield it, push right then left so left comes out first; O(n)
+Generator<AVLTree::NodeView> AVLTree::generatePreorder()
+{
+    vector<TreeNode*> stack;
+    if (root != nullptr)
+    {
+        stack.push_back(root);
+    }
+    while (!stack.empty())
+    {
+        TreeNode* node = stack.back();
+        stack.pop_back();
+        if (node->right != nullptr)
+            stack.push_back(node->right);
+        if (node->left != nullptr)
+            stack.push_back(node->left);
+        if (!node->deleted)
+        {
+            co_yield NodeView{node->ufid, node->name, node->key};
+        }
+    }
+}
+
+
+// yields every live student in postorder: a node is yielded once the walk comes back to it from its right subtree
+// (or it has none); O(n)
+Generator<AVLTree::NodeView> AVLTree::generatePostorder()
+{
+    vector<TreeNode*> stack;
+    TreeNode* node = root;
+    TreeNode* lastVisited = nullptr;
+    while (node != nullptr || !stack.empty())
+    {
+        while (node != nullptr)
+        {
+            stack.push_back(node);
+            node = node->left;
+        }
+        TreeNode* top = stack.back();
+        if (top->right != nullptr && top->right != lastVisited)
+        {
+            node = top->right;
+            continue;
+        }
+        stack.pop_back();
+        lastVisited = top;
+        if (!top->deleted)
+        {
+            co_yield NodeView{top->ufid, top->name, top->key};
+        }
+    }
+}
+#endif
+
+
+// prints preorder traversal of the AVLTree; O(n)
+void AVLTree::printPreorder()
+{
+    // print each name as the walk reaches it, separated by commas (nothing at all for an empty tree)
+    bool first = true;
+    forEachPreorder([&first](const NodeView& student)
+    {
+        cout << (first ? "" : ", ") << student.name;
+        first = false;
+        return true;
+    });
+    if (!first)
+    {
+        cout << endl;
+    }
+}
+
+
+// prints inorder traversal of the AVLTree; O(n)
+void AVLTree::printInorder()
+{
+    // print each name as the walk reaches it, separated by commas (nothing at all for an empty tree)
+    bool first = true;
+    forEachInorder([&first](const NodeView& student)
+    {
+        cout << (first ? "" : ", ") << student.name;
+        first = false;
+        return true;
+    });
+    if (!first)
+    {
+        cout << endl;
+    }
+}
+
+
+// prints postorder traversal of the AVLTree; O(n)
+void AVLTree::printPostOrder()
+{
+    // print each name as the walk reaches it, separated by commas (nothing at all for an empty tree)
+    bool first = true;
+    forEachPostorder([&first](const NodeView& student)
+    {
+        cout << (first ? "" : ", ") << student.name;
+        first = false;
+        return true;
+    });
+    if (!first)
+    {
+        cout << endl;
+    }
+}
+
+
+// appends to "pieces", in inorder, every live node shallower than "cutoff" as a lone piece and every subtree rooted at
+// depth "cutoff" as a whole piece; O(2^cutoff)
+void AVLTree::collectExportPieces(TreeNode* node, int depth, int cutoff, vector<ExportPiece>& pieces)
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+    if (depth == cutoff)
+    {
+        pieces.push_back(ExportPiece{node, true, "", 0});
+        return;
+    }
+    collectExportPieces(node->left, depth + 1, cutoff, pieces);
+    if (!node->deleted)
+    {
+        pieces.push_back(ExportPiece{node, false, "", 0});
+    }
+    collectExportPieces(node->right, depth + 1, cutoff, pieces);
+}
+
+
+// renders the names of one export piece, comma separated, into its own buffer; O(subtree size)
+void AVLTree::renderExportPiece(ExportPiece& piece)
+{
+    if (!piece.wholeSubtree)
+    {
+        piece.text = piece.node->name;
+        piece.count = 1;
+        return;
+    }
+    auto append = [&piece](TreeNode* node)
+    {
+        if (piece.count++ > 0)
+        {
+            piece.text += ", ";
+        }
+        piece.text += node->name;
+        return true;
+    };
+    walkInorder(piece.node, append);
+}
+
+
+// prints inorder traversal of the AVLTree to "out", rendering it on several threads; O(n) work
+void AVLTree::exportInorder(ostream& out, unsigned threads)
+{
+    if (threads == 0)
+    {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+
+    // cut deep enough for about 8 subtrees per thread: AVL subtrees at one depth can differ a lot in size, and idle
+    // workers steal the leftovers of busy ones
+    int cutoff = 0;
+    while (threads > 1 && (1u << cutoff) < 8 * threads && cutoff < 20)
+    {
+        cutoff++;
+    }
+    vector<ExportPiece> pieces;
+    collectExportPieces(root, 0, cutoff, pieces);
+
+    if (threads == 1)
+    {
+        for (ExportPiece& piece : pieces)
+        {
+            renderExportPiece(piece);
+        }
+    }
+    else
+    {
+        WorkStealingPool pool(threads);
+        for (ExportPiece& piece : pieces)
+        {
+            if (piece.wholeSubtree)
+            {
+                pool.submit([this, &piece] { renderExportPiece(piece); });
+            }
+            else
+            {
+                renderExportPiece(piece);
+            }
+        }
+        pool.wait();
+    }
+
+    // stitch the buffers together in order, freeing each once written
+    bool first = true;
+    for (ExportPiece& piece : pieces)
+    {
+        if (piece.count == 0)
+        {
+            continue;
+        }
+        if (!first)
+        {
+            out << ", ";
+        }
+        out.write(piece.text.data(), piece.text.size());
+        string().swap(piece.text);
+        first = false;
+    }
+    if (!first)
+    {
+        out << endl;
+    }
+}
+
+
+// prints number of levels that exist in the tree; O(log n)
+void AVLTree::printLevelCount()
+{
+    int levelCount;
+
+    // if tree is empty, levelCount = 0
+    if (root == nullptr)
+    {
+        levelCount = 0;
+        cout << levelCount << endl;
+    }
+    // Else, levelCount = height of the root node
+    else
+    {
+        levelCount = height(root);
+        cout << levelCount << endl;
+    }
+}
+
+
+//=====================================================//
+//           Search Function Definitions               //
+//=====================================================//
+
+// Searches for "name" in the tree; O(n)
+void AVLTree::searchName(string name)
+{
+    // print the ufid of every student named "name" in preorder (NLR)
+    bool found = false;
+    forEachPreorder([&](const NodeView& student)
+    {
+        if (student.name == name)
+        {
+            cout << student.ufid << endl;
+            found = true;
+        }
+        return true;
+    });
+
+    // name was not found
+    if (!found)
+    {
+        cout << unsuccess << endl;
+    }
+}
+
+
+// Helper function walks down from "node" to find the node w/ specified "ufid", comparing integer keys; O(log n)
+AVLTree::TreeNode* AVLTree::searchIdHelper(TreeNode* node, string ufid)
+{
+    // convert the ufid to search for to an integer "key" once
+    int key = ufidKey(ufid);
+
+    // check through the nodes children until the key is found, else return nullptr
+    while (node != nullptr)
+    {
+        treeStats.add(TreeStats::SearchVisits);
+        if (key < node->key)
+        {
+            node = node->left;
+        }
+        else if (key > node->key)
+        {
+            node = node->right;
+        }
+        else
+        {
+            // the key matches; it is only found if the ufid string matches too (and the node is not a tombstone)
+            return node->ufid == ufid && !node->deleted ? node : nullptr;
+        }
+    }
+
+    // return nullptr if ufid cant be found
+    return nullptr;
+}
+
+
+// Searches for "ufid" in the tree; O(log n)
+void AVLTree::searchId(string ufid)
+{
+    treeStats.add(TreeStats::Searches);
+
+    // if the ufid filter rules the ufid out, it is not in the tree and there is no need to descend
+    if (idFilterEnabled && root != nullptr && !idFilter.mayContain(ufidKey(ufid)))
+    {
+        cout << unsuccess << endl;
+        return;
+    }
+
+    // in hybrid hash mode the hash table answers the search in O(1); the tree is only used for ordered walks
+    if (idHashEnabled)
+    {
+        TreeNode* hashedNode = nullptr;
+        if (root != nullptr && idHash.find(ufidKey(ufid), hashedNode) && hashedNode->ufid == ufid)
+        {
+            cout << hashedNode->name << endl;
+        }
+        else
+        {
+            // not found; if the filter let it through, that was a false positive
+            if (idFilterEnabled && root != nullptr)
+            {
+                idFilter.recordFalsePositive();
+            }
+            cout << unsuccess << endl;
+        }
+        return;
+    }
+
+    // hot ufids are answered straight from the cache; the string compare keeps "0012" from matching "00000012"
+    TreeNode* foundNode = nullptr;
+    int key = idCache.capacity() == 0 ? 0 : ufidKey(ufid);
+    if (idCache.capacity() != 0 && idCache.find(key, foundNode) && foundNode->ufid == ufid)
+    {
+        cout << foundNode->name << endl;
+        return;
+    }
+
+    foundNode = searchIdHelper(root, ufid);
+    if (foundNode != nullptr)
+    {
+        idCache.put(key, foundNode);
+    }
+    
+    // if found prints associated "name", otherwise prints "unsuccessful"
+    if(foundNode == nullptr)
+    {
+        // name was not found; if the filter let it through, that was a false positive
+        if (idFilterEnabled && root != nullptr)
+        {
+            idFilter.recordFalsePositive();
+        }
+        cout << unsuccess << endl;
+    }
+    else
+    {
+        // name was found, print the associated name
+        cout << foundNode->name << endl;
+    }
+}
+
+
+// Searches for every name starting with "prefix" (ignoring case) using the name index, printing at most "limit" matches; O(log n + k)
+void AVLTree::searchNamePrefix(string prefix, int limit)
+{
+    vector<pair<string, string>> matches = nameIndex.matchPrefix(prefix, limit);
+
+    // if found prints each match as "NAME" UFID in name order, otherwise prints "unsuccessful"
+    if (matches.size() == 0)
+    {
+        cout << unsuccess << endl;
+    }
+    else
+    {
+        for (const pair<string, string>& match : matches)
+        {
+            cout << "\"" << match.first << "\" " << match.second << endl;
+        }
+    }
+}
+
+
+// Searches for "name" ignoring case using the name index, printing the associated ufids in ufid order; O(log n + k)
+void AVLTree::searchNameIgnoreCase(string name)
+{
+    vector<pair<string, string>> matches = nameIndex.matchName(name);
+
+    // if found prints associated "ufid"s, otherwise prints "unsuccessful"
+    if (matches.size() == 0)
+    {
+        cout << unsuccess << endl;
+    }
+    else
+    {
+        for (const pair<string, string>& match : matches)
+        {
+            cout << match.second << endl;
+        }
+    }
+}
+
+
+// Helper function using inorder traversal to collect nodes with lowUfid <= key <= highUfid; O(log n + k)
+void AVLTree::searchRangeHelper(TreeNode* node, int low, int high, vector<TreeNode*>& found)
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    int currId = node->key;
+
+    // only descend left if smaller keys can still be in range (L)
+    if (low < currId)
+    {
+        searchRangeHelper(node->left, low, high, found);
+    }
+
+    // (N)
+    if (low <= currId && currId <= high && !node->deleted)
+    {
+        found.push_back(node);
+    }
+
+    // only descend right if larger keys can still be in range (R)
+    if (currId < high)
+    {
+        searchRangeHelper(node->right, low, high, found);
+    }
+}
+
+
+// Searches for every ufid between "lowUfid" and "highUfid" (inclusive), printing them in ufid order; O(log n + k)
+void AVLTree::searchRange(string lowUfid, string highUfid)
+{
+    vector<TreeNode*> found;
+    searchRangeHelper(root, ufidKey(lowUfid), ufidKey(highUfid), found);
+
+    // if found prints each node as "NAME" UFID, otherwise prints "unsuccessful"
+    if (found.size() == 0)
+    {
+        cout << unsuccess << endl;
+    }
+    else
+    {
+        for (TreeNode* node : found)
+        {
+            cout << "\"" << node->name << "\" " << node->ufid << endl;
+        }
+    }
+}
+
+
+//=====================================================//
+//        Secondary Index Function Definitions         //
+//=====================================================//
+
+// adds the data held by "node" to every secondary index; O(log n)
+void AVLTree::indexNode(TreeNode* node, bool withName)
+{
+    if (withName)
+    {
+        nameIndex.insert(node->name, node->ufid);
+    }
+
+    if (idHashEnabled)
+    {
+        idHash.put(node->key, node);
+    }
+
+    if (idFilterEnabled)
+    {
+        // grow the filter before it saturates and its false positive rate climbs
+        if (idFilter.size() >= idFilter.capacity())
+        {
+            rebuildIdFilter(2 * idFilter.capacity());
+        }
+        idFilter.insert(node->key);
+    }
+}
+
+
+// drops the data held by "node" from every secondary index; O(log n)
+void AVLTree::unindexNode(TreeNode* node)
+{
+    nameIndex.erase(node->name, node->ufid);
+
+    if (idHashEnabled)
+    {
+        idHash.erase(node->key);
+    }
+
+    // the node is about to be freed or overwritten with its successor's data, so its cache entry is stale
+    if (idCache.capacity() != 0)
+    {
+        idCache.erase(node->key);
+    }
+
+    // a Bloom filter cannot forget a key; count it so the filter is rebuilt once enough have gone stale
+    if (idFilterEnabled)
+    {
+        idFilterStale++;
+    }
+}
+
+
+// clears the ufid filter and re-adds every ufid in the tree, using an explicit stack; O(n)
+void AVLTree::rebuildIdFilter(size_t expectedCount)
+{
+    idFilter.reset(expectedCount);
+    idFilterStale = 0;
+
+    vector<TreeNode*> stack;
+    if (root != nullptr)
+    {
+        stack.push_back(root);
+    }
+    while (!stack.empty())
+    {
+        TreeNode* node = stack.back();
+        stack.pop_back();
+        if (!node->deleted)
+            idFilter.insert(node->key);
+        if (node->left != nullptr)
+            stack.push_back(node->left);
+        if (node->right != nullptr)
+            stack.push_back(node->right);
+    }
+}
+
+
+// rebuilds the ufid filter once more than half of the ufids it holds have been removed; amortized O(1)
+void AVLTree::maybeRebuildIdFilter()
+{
+    if (idFilterEnabled && idFilterStale > idFilter.size() / 2)
+    {
+        rebuildIdFilter(idFilter.capacity());
+    }
+}
+
+
+// turns on the ufid filter, filling it with the ufids already in the tree; O(n)
+void AVLTree::enableIdFilter(size_t expectedCount)
+{
+    idFilterEnabled = true;
+    rebuildIdFilter(expectedCount);
+}
+
+
+// turns off the ufid filter and releases its memory; O(1)
+void AVLTree::disableIdFilter()
+{
+    idFilterEnabled = false;
+    idFilter.reset(0);
+}
+
+
+// returns the filter's query / filter hit / false positive counters
+IdFilter::Stats AVLTree::idFilterStats()
+{
+    return idFilter.stats();
+}
+
+
+// turns on the searchId cache with "slotCount" slots; O(slots)
+void AVLTree::enableIdCache(size_t slotCount)
+{
+    idCache.reset(slotCount);
+}
+
+
+// turns off the searchId cache and releases its memory; O(1)
+void AVLTree::disableIdCache()
+{
+    idCache.reset(0);
+}
+
+
+// returns the cache's hit / miss / invalidation counters
+HotCache<AVLTree::TreeNode*>::Stats AVLTree::idCacheStats()
+{
+    return idCache.stats();
+}
+
+
+// turns on hybrid hash mode, hashing every node already in the tree (using an explicit stack); O(n)
+void AVLTree::enableIdHash()
+{
+    idHashEnabled = true;
+    idHash.clear();
+
+    vector<TreeNode*> stack;
+    if (root != nullptr)
+    {
+        stack.push_back(root);
+    }
+    while (!stack.empty())
+    {
+        TreeNode* node = stack.back();
+        stack.pop_back();
+        if (!node->deleted)
+            idHash.put(node->key, node);
+        if (node->left != nullptr)
+            stack.push_back(node->left);
+        if (node->right != nullptr)
+            stack.push_back(node->right);
+    }
+}
+
+
+// turns off hybrid hash mode and releases the hash table; O(1)
+void AVLTree::disableIdHash()
+{
+    idHashEnabled = false;
+    idHash.clear();
+}
+
+
+//=====================================================//
+//           Remove Function Definitions               //
+//=====================================================//
+
+// Helper function to find the node with the key of "ufid" below "node", returns nullptr if it is not in the tree; O(log n)
+AVLTree::TreeNode* AVLTree::locateKey(TreeNode* node, string ufid)
+{
+    if (node == nullptr)
+    {
+        // node is not in tree
+        return nullptr;
+    }
+
+    // variable to compare the passed in ufid to remove against the keys in the nodes
+    int key = ufidKey(ufid);
+
+    while (node != nullptr)
+    {
+        if (key < node->key)
+        {
+            node = node->left;
+        }
+        else if (key > node->key)
+        {
+            node = node->right;
+        }
+        else
+        {
+            // item is found
+            return node;
+        }
+    }
+
+    // fell off the tree, node is not in tree
+    return nullptr;
+}
+
+
+// Helper function to find the node with the key of "ufid" below "node" and remove it, returns false if it is not in the tree; O(log n)
+bool AVLTree::removeHelper(TreeNode* node, string ufid)
+{
+    // unlink it and rebalance above it (removeNode retraces from the parent up to the root), or just tombstone it in
+    // tombstone mode
+    TreeNode* found = locateKey(node, ufid);
+    return found != nullptr && retireNode(found);
+}
+
+
+// unlinks "node" from the tree and retraces from the lowest node whose subtree changed; O(log n)
+void AVLTree::removeNode(TreeNode* node)
+{
+    // drop its data from the secondary indexes before unlinking it
+    unindexNode(node);
+    treeStats.add(TreeStats::Removes);
+
+    // local root has 2 children
+    if (node->left != nullptr && node->right != nullptr)
+    {
+        // find inorder successor to replace removed node; inorder successor = minimum node of right subtree
+        TreeNode* tempNode = minNode(node->right);
+
+        // copy its data into local roots data, re-index it under the node that now holds it, then remove the successor instead
+        unindexNode(tempNode);
+        node->name = tempNode->name;
+        node->ufid = tempNode->ufid;
+        node->key = tempNode->key;
+        indexNode(node);
+        node = tempNode;
+    }
+
+    // local root now has at most 1 child; set parent of local root to reference that child (or nullptr)
+    TreeNode* child = node->left != nullptr ? node->left : node->right;
+    TreeNode* parent = node->parent;
+    replaceChild(parent, node, child);
+    delete node;
+
+    // fix heights on the way back up, rotating wherever the removal unbalanced a subtree
+    retrace(parent);
+}
+
+
+// removes a located node; in tombstone mode it only drops the node from the indexes and marks it, compacting the
+// tree once tombstones pass the threshold, so a burst of removes causes no rotations; O(log n) (amortized in tombstone mode)
+bool AVLTree::retireNode(TreeNode* node)
+{
+    if (!tombstonesEnabled)
+    {
+        removeNode(node);
+        return true;
+    }
+    if (node->deleted)
+    {
+        return false;
+    }
+
+    unindexNode(node);
+    node->deleted = true;
+    tombstones++;
+    treeStats.add(TreeStats::Removes);
+
+    // nameIndex holds exactly the live students
+    if (tombstones > compactionThreshold * (tombstones + nameIndex.size()))
+    {
+        compact();
+    }
+    return true;
+}
+
+
+// removes node with given "ufid" from the tree, if it exists; O(log n)
+void AVLTree::remove(string ufid)
+{
+    // if the ufid filter rules the ufid out, there is nothing to remove
+    if (idFilterEnabled && root != nullptr && !idFilter.mayContain(ufidKey(ufid)))
+    {
+        cout << unsuccess << endl;
+        return;
+    }
+
+    // locate the node first, so the remove is logged before the tree changes: in hybrid hash mode the hash table finds it
+    // in O(1) and its parent pointers lead the retrace, otherwise one descent finds it and the unlink needs no second one
+    TreeNode* node = nullptr;
+    bool found;
+    if (idHashEnabled && root != nullptr)
+    {
+        found = idHash.find(ufidKey(ufid), node);
+    }
+    else
+    {
+        node = locateKey(this->root, ufid);
+        found = node != nullptr && !node->deleted;
+    }
+    if (!found)
+    {
+        // not found; if the filter let it through, that was a false positive
+        if (idFilterEnabled && root != nullptr)
+        {
+            idFilter.recordFalsePositive();
+        }
+        cout << unsuccess << endl;
+        return;
+    }
+
+    // an update the log could not record is not made at all
+    if (wal.isOpen() && !wal.append(WriteAheadLog::Remove, ufid))
+    {
+        cout << unsuccess << endl;
+        return;
+    }
+    retireNode(node);
+    maybeRebuildIdFilter();
+    cout << success << endl;
+}
+
+
+// fills "inorderVec" with the inorder traversal (LNR) of the nodes in the tree; O(n)
+void AVLTree::inorder(TreeNode* node)
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+    else
+    {
+        inorder(node->left);          // L
+        if (!node->deleted)
+            inorderVec.push_back(node);   // N
+        inorder(node->right);         // R
+    }
+}
+
+
+// Helper function to remove "n"th node in inorder traversal from AVLTree; O(n)
+AVLTree::TreeNode* AVLTree::removeInorderHelper(TreeNode* node, int n)
+{
+    // if node is empty, return nullptr
+    if (node == nullptr)
+    {
+        return nullptr;
+    }
+
+    // fill "inorderVec" with the inorder traversal of all nodes in the AVLTree (dropping the previous call's
+    // traversal, whose nodes may since have been freed)
+    inorderVec.clear();
+    inorder(root);
+
+    if (n >= inorderVec.size())
+    {
+        // n is larger than the number of nodes in the tree, and so the node does not exist
+        cout << unsuccess << endl;
+        return node;
+    }
+
+    // create variable of the node to be removed by calling the n'th node in "inorderVec"
+    TreeNode* nodeToRemove = inorderVec[n];
+    
+    // log the removal by ufid, so replaying it does not depend on the tree's order at replay time; an update the log
+    // could not record is not made at all
+    if (wal.isOpen() && !wal.append(WriteAheadLog::Remove, nodeToRemove->ufid))
+    {
+        cout << unsuccess << endl;
+        return node;
+    }
+
+    // the node is already located, so unlink it directly instead of descending for its ufid again
+    retireNode(nodeToRemove);
+    cout << success << endl;
+    return root;
+}
+
+
+// removes the n'th ufid in the inorder traversal of the tree; O(n)
+void AVLTree::removeInorder(int n)
+{
+    removeInorderHelper(root, n);
+    maybeRebuildIdFilter();
+}
+
+
+//=====================================================//
+//           Snapshot Function Definitions             //
+//=====================================================//
+
+// Snapshot layout (native byte order): "AVLS", uint32 version, uint64 node count, then one record per node in preorder:
+//   uint8 flags (1 = has left child, 2 = has right child), uint8 height, int8 balance factor, uint8 ufid length,
+//   uint32 key, uint32 name length, name bytes
+// Preorder plus the child flags pins down the exact shape, so loading relinks the nodes without a single comparison or rotation.
+static const char snapshotMagic[4] = {'A', 'V', 'L', 'S'};
+static const uint32_t snapshotVersion = 1;
+
+
+// frees every node (using an explicit stack) and resets the secondary indexes; O(n)
+void AVLTree::clear()
+{
+    vector<TreeNode*> stack;
+    if (root != nullptr)
+    {
+        stack.push_back(root);
+    }
+    while (!stack.empty())
+    {
+        TreeNode* node = stack.back();
+        stack.pop_back();
+        if (node->left != nullptr)
+            stack.push_back(node->left);
+        if (node->right != nullptr)
+            stack.push_back(node->right);
+        delete node;
+    }
+    root = nullptr;
+    inorderVec.clear();
+    tombstones = 0;
+
+    nameIndex.clear();
+    idCache.reset(idCache.capacity());
+    if (idHashEnabled)
+        idHash.clear();
+    if (idFilterEnabled)
+        rebuildIdFilter(idFilter.capacity());
+}
+
+
+// writes the tree in preorder (using an explicit stack) to "path"; O(n)
+bool AVLTree::saveSnapshot(string path)
+{
+    // the format records the exact shape, so tombstones are compacted away rather than written
+    if (tombstones != 0)
+    {
+        compact();
+    }
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+
+    vector<TreeNode*> nodes;
+    if (root != nullptr)
+    {
+        nodes.push_back(root);
+    }
+
+    // header; the node count is patched in once the walk has counted the nodes
+    uint64_t count = 0;
+    file.write(snapshotMagic, 4);
+    file.write((const char*)&snapshotVersion, sizeof(snapshotVersion));
+    file.write((const char*)&count, sizeof(count));
+
+    string record;
+    while (!nodes.empty())
+    {
+        TreeNode* node = nodes.back();
+        nodes.pop_back();
+
+        uint8_t header[4];
+        header[0] = (uint8_t)((node->left != nullptr ? 1 : 0) | (node->right != nullptr ? 2 : 0));
+        header[1] = (uint8_t)node->height;
+        header[2] = (uint8_t)(int8_t)node->balanceFactor;
+        header[3] = (uint8_t)node->ufid.size();
+        uint32_t key = (uint32_t)node->key;
+        uint32_t nameLength = (uint32_t)node->name.size();
+
+        record.assign((const char*)header, 4);
+        record.append((const char*)&key, 4);
+        record.append((const char*)&nameLength, 4);
+        record.append(node->name);
+        file.write(record.data(), record.size());
+        count++;
+
+        // push right first so the left subtree is written first (NLR)
+        if (node->right != nullptr)
+            nodes.push_back(node->right);
+        if (node->left != nullptr)
+            nodes.push_back(node->left);
+    }
+
+    file.seekp(8);
+    file.write((const char*)&count, sizeof(count));
+    return (bool)file;
+}
+
+
+// replaces the tree with the one stored in "path", reading the mmapped file in one sequential pass; O(n)
+// the file is parsed into nodes of its own first, so a missing, truncated or malformed file leaves the tree (and the log)
+// exactly as they were
+bool AVLTree::loadSnapshot(string path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 16)
+    {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)info.st_size;
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    const char* data = (const char*)mapping;
+    const char* end = data + size;
+    uint32_t version;
+    uint64_t count;
+    memcpy(&version, data + 4, 4);
+    memcpy(&count, data + 8, 8);
+    bool valid = memcmp(data, snapshotMagic, 4) == 0 && version == snapshotVersion;
+    const char* cursor = data + 16;
+
+    // nodes whose children are still to come, with their child flags and whether the left child was already linked
+    struct Pending
+    {
+        TreeNode* node;
+        uint8_t flags;
+        bool leftDone;
+    };
+    vector<Pending> pending;
+
+    // names are collected and handed to the name index in one sorted batch, which is far cheaper than n map inserts;
+    // the nodes are kept in file order to be indexed once the whole file has checked out (or freed if it does not)
+    TreeNode* loadedRoot = nullptr;
+    vector<TreeNode*> nodes;
+    vector<pair<string, string>> names;
+    nodes.reserve(valid ? (size_t)min<uint64_t>(count, size / 12) : 0);
+    names.reserve(nodes.capacity());
+
+    char ufid[16];
+    for (uint64_t i = 0; valid && i < count; i++)
+    {
+        // every record needs its fixed 12 bytes, its name, and a parent still waiting for a child (except the root)
+        if (end - cursor < 12 || (i > 0 && pending.empty()))
+        {
+            valid = false;
+            break;
+        }
+        uint8_t flags = (uint8_t)cursor[0];
+        uint32_t key;
+        uint32_t nameLength;
+        memcpy(&key, cursor + 4, 4);
+        memcpy(&nameLength, cursor + 8, 4);
+        int ufidLength = snprintf(ufid, sizeof(ufid), "%0*u", (int)(uint8_t)cursor[3], key);
+        if ((size_t)(end - cursor - 12) < nameLength || ufidLength < 0 || ufidLength >= (int)sizeof(ufid))
+        {
+            valid = false;
+            break;
+        }
+
+        TreeNode* node = new TreeNode();
+        node->height = (uint8_t)cursor[1];
+        node->balanceFactor = (int8_t)cursor[2];
+        node->key = (int)key;
+        node->ufid.assign(ufid, ufidLength);
+        node->name.assign(cursor + 12, nameLength);
+        cursor += 12 + nameLength;
+
+        // link the node under the parent waiting for it: its left slot first if it has one, then its right slot
+        if (pending.empty())
+        {
+            loadedRoot = node;
+        }
+        else
+        {
+            Pending& top = pending.back();
+            node->parent = top.node;
+            if ((top.flags & 1) && !top.leftDone)
+            {
+                top.node->left = node;
+                top.leftDone = true;
+                if ((top.flags & 2) == 0)
+                    pending.pop_back();
+            }
+            else
+            {
+                top.node->right = node;
+                pending.pop_back();
+            }
+        }
+        if (flags != 0)
+        {
+            Pending waiting = {node, flags, false};
+            pending.push_back(waiting);
+        }
+        nodes.push_back(node);
+        names.push_back(make_pair(node->name, node->ufid));
+    }
+    munmap(mapping, size);
+
+    // a truncated or malformed file is dropped whole; the current tree is only replaced by a complete one
+    if (!valid || !pending.empty())
+    {
+        for (TreeNode* node : nodes)
+        {
+            delete node;
+        }
+        return false;
+    }
+    clear();
+    root = loadedRoot;
+    for (TreeNode* node : nodes)
+    {
+        indexNode(node, false);
+    }
+    nameIndex.assign(names);
+
+    // the log only holds changes made since the last checkpoint, so a tree replaced wholesale has to become the new
+    // checkpoint; otherwise recovery would replay the records logged after this load onto the tree from before it
+    return !wal.isOpen() || checkpoint();
+}
+
+
+//=====================================================//
+//           Durability Function Definitions           //
+//=====================================================//
+
+// loads the last checkpoint (if any), replays the log on top of it without printing, then opens the log for appends; O(n)
+// replay is safe even if a crash hit between writing a checkpoint and emptying the log: each ufid's records alternate
+// insert / remove, so replaying them over a newer state still ends on the same final state for that ufid
+bool AVLTree::enableWal(string logPath, string snapshotPath, int groupCommitMicros)
+{
+    wal.close();
+    walSnapshotPath = snapshotPath;
+
+    struct stat info;
+    if (stat(snapshotPath.c_str(), &info) == 0 && !loadSnapshot(snapshotPath))
+    {
+        return false;
+    }
+
+    WriteAheadLog::replay(logPath, [this](WriteAheadLog::Op op, const string& ufid, const string& name)
+    {
+        if (op == WriteAheadLog::Insert)
+            insertHelper(name, ufid);
+        else if (op == WriteAheadLog::Remove)
+            removeHelper(root, ufid);
+    });
+    maybeRebuildIdFilter();
+
+    return wal.open(logPath, chrono::microseconds(groupCommitMicros));
+}
+
+
+// writes a snapshot next to the current one, makes it and its rename durable, swaps it in, then empties the log; O(n)
+bool AVLTree::checkpoint()
+{
+    if (!wal.isOpen())
+    {
+        return false;
+    }
+
+    string temporaryPath = walSnapshotPath + ".tmp";
+    if (!wal.sync() || !saveSnapshot(temporaryPath))
+    {
+        return false;
+    }
+
+    // the snapshot has to be on disk before the rename makes it the one recovery reads
+    int fd = open(temporaryPath.c_str(), O_RDONLY);
+    bool durable = fd >= 0 && fsync(fd) == 0;
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    if (!durable || rename(temporaryPath.c_str(), walSnapshotPath.c_str()) != 0)
+    {
+        return false;
+    }
+
+    // the rename only lives in the directory until that is synced too; emptying the log before then could leave a
+    // crash with neither the new snapshot nor the records it replaced
+    size_t slash = walSnapshotPath.rfind('/');
+    string directory = slash == string::npos ? "." : slash == 0 ? "/" : walSnapshotPath.substr(0, slash);
+    int directoryFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    bool renamed = directoryFd >= 0 && fsync(directoryFd) == 0;
+    if (directoryFd >= 0)
+    {
+        close(directoryFd);
+    }
+    if (!renamed)
+    {
+        return false;
+    }
+    return wal.truncate();
+}
+
+
+// syncs pending log records and stops logging; O(1)
+void AVLTree::disableWal()
+{
+    wal.close();
+}
+
+
+//=====================================================//
+//          Statistics Function Definitions            //
+//=====================================================//
+
+// returns a copy of the operation counters; O(1)
+TreeStats::Snapshot AVLTree::stats()
+{
+    return treeStats.snapshot();
+}
+
+
+// prints every operation counter as "name value", followed by the average nodes visited per searchId; O(1)
+void AVLTree::printStats()
+{
+    TreeStats::Snapshot counters = treeStats.snapshot();
+    cout << "inserts " << counters.inserts << endl;
+    cout << "duplicateInserts " << counters.duplicateInserts << endl;
+    cout << "removes " << counters.removes << endl;
+    cout << "rotateLeft " << counters.rotateLeft << endl;
+    cout << "rotateRight " << counters.rotateRight << endl;
+    cout << "rotateLeftRight " << counters.rotateLeftRight << endl;
+    cout << "rotateRightLeft " << counters.rotateRightLeft << endl;
+    cout << "searches " << counters.searches << endl;
+    cout << "searchVisits " << counters.searchVisits << endl;
+    cout << "visitsPerSearch " << counters.visitsPerSearch() << endl;
+    cout << "tombstones " << tombstones << endl;
+    cout << "tombstoneRatio " << (tombstones == 0 ? 0.0 : (double)tombstones / (tombstones + nameIndex.size())) << endl;
+    cout << "compactions " << counters.compactions << endl;
+}
+
+
+// zeroes every operation counter; O(1)
+void AVLTree::resetStats()
+{
+    treeStats.reset();
+}
+
+
+//=====================================================//
+//           Analysis Function Definitions             //
+//=====================================================//
+
+// walks every node once with an explicit stack of (node, depth), so a degenerate tree cannot overflow the call stack; O(n)
+AVLTree::Analysis AVLTree::analyze()
+{
+    Analysis report;
+    report.height = height(root);
+
+    size_t depthSum = 0;
+    vector<pair<TreeNode*, int>> stack;
+    if (root != nullptr)
+    {
+        stack.push_back(make_pair(root, 1));
+    }
+    while (!stack.empty())
+    {
+        TreeNode* node = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+
+        report.nodeCount++;
+        report.tombstones += node->deleted ? 1 : 0;
+        depthSum += depth;
+        report.maxDepth = max(report.maxDepth, depth);
+
+        // recompute the balance from the children rather than trusting the stored value
+        int balance = height(node->left) - height(node->right);
+        if (balance >= -1 && balance <= 1)
+            report.balanceCounts[balance + 1]++;
+        else
+            report.unbalancedNodes++;
+
+        // short strings live inside the TreeNode itself; longer ones own a separate heap block
+        report.nodeBytes += malloc_usable_size(node);
+        const char* nodeStart = (const char*)node;
+        for (const string* text : {&node->name, &node->ufid})
+        {
+            if (text->data() < nodeStart || text->data() >= nodeStart + sizeof(TreeNode))
+                report.stringBytes += malloc_usable_size((void*)text->data());
+        }
+
+        if (node->left != nullptr)
+            stack.push_back(make_pair(node->left, depth + 1));
+        if (node->right != nullptr)
+            stack.push_back(make_pair(node->right, depth + 1));
+    }
+
+    if (report.nodeCount != 0)
+    {
+        report.averageDepth = (double)depthSum / report.nodeCount;
+        report.optimalHeight = (int)ceil(log2((double)report.nodeCount + 1));
+    }
+
+    // allocator totals cover the whole process, not just this tree
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 heap = mallinfo2();
+    report.heapInUse = heap.uordblks;
+    report.heapFree = heap.fordblks;
+    report.heapMapped = heap.hblkhd;
+    if (heap.uordblks + heap.fordblks != 0)
+    {
+        report.fragmentation = (double)heap.fordblks / (heap.uordblks + heap.fordblks);
+    }
+#endif
+    return report;
+}
+
+
+// prints the analyze() report one "name value" pair per line; O(n)
+void AVLTree::printAnalysis()
+{
+    Analysis report = analyze();
+    cout << "nodes " << report.nodeCount << endl;
+    cout << "tombstones " << report.tombstones << endl;
+    cout << "height " << report.height << endl;
+    cout << "optimalHeight " << report.optimalHeight << endl;
+    cout << "averageDepth " << report.averageDepth << endl;
+    cout << "maxDepth " << report.maxDepth << endl;
+    cout << "balance-1 " << report.balanceCounts[0] << endl;
+    cout << "balance0 " << report.balanceCounts[1] << endl;
+    cout << "balance+1 " << report.balanceCounts[2] << endl;
+    cout << "unbalanced " << report.unbalancedNodes << endl;
+    cout << "nodeBytes " << report.nodeBytes << endl;
+    cout << "stringBytes " << report.stringBytes << endl;
+    cout << "heapInUse " << report.heapInUse << endl;
+    cout << "heapFree " << report.heapFree << endl;
+    cout << "heapMapped " << report.heapMapped << endl;
+    cout << "fragmentation " << report.fragmentation << endl;
+}
+
+
+//=====================================================//
+//           Tombstone Function Definitions            //
+//=====================================================//
+
+// turns on lazy deletion; "threshold" is the fraction of tombstones among all nodes that triggers a compaction; O(1)
+void AVLTree::enableTombstones(double threshold)
+{
+    tombstonesEnabled = true;
+    compactionThreshold = threshold;
+}
+
+
+// compacts away the remaining tombstones, then goes back to unlinking removed nodes; O(n)
+void AVLTree::disableTombstones()
+{
+    if (tombstones != 0)
+    {
+        compact();
+    }
+    tombstonesEnabled = false;
+}
+
+
+// relinks nodes[low..high] into a perfectly balanced subtree, setting every height and balance factor on the way up; O(k)
+AVLTree::TreeNode* AVLTree::buildBalanced(vector<TreeNode*>& nodes, int low, int high, TreeNode* parent)
+{
+    if (low > high)
+    {
+        return nullptr;
+    }
+
+    int middle = low + (high - low) / 2;
+    TreeNode* node = nodes[middle];
+    node->parent = parent;
+    node->left = buildBalanced(nodes, low, middle - 1, node);
+    node->right = buildBalanced(nodes, middle + 1, high, node);
+    updateHeight(node);
+    return node;
+}
+
+
+// rebuilds the whole tree from its live nodes in one pass, freeing the tombstones: no comparisons and no rotations,
+// and the live nodes are relinked rather than copied, so every index entry pointing at them stays valid; O(n)
+void AVLTree::compact()
+{
+    vector<TreeNode*> live;
+    live.reserve(nameIndex.size());
+
+    // iterative inorder walk, so the live nodes come out sorted by key
+    vector<TreeNode*> stack;
+    TreeNode* node = root;
+    while (node != nullptr || !stack.empty())
+    {
+        while (node != nullptr)
+        {
+            stack.push_back(node);
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        TreeNode* next = node->right;
+        if (node->deleted)
+            delete node;
+        else
+            live.push_back(node);
+        node = next;
+    }
+
+    root = buildBalanced(live, 0, (int)live.size() - 1, nullptr);
+    tombstones = 0;
+    inorderVec.clear();
+    treeStats.add(TreeStats::Compactions);
+}
+
+
+//=====================================================//
+//            Bulk Build Function Definitions          //
+//=====================================================//
+
+// loads "students" in four parallel passes over the pool: key extraction, sort, duplicate counting, node creation; then
+// links the tree and sorts the name index in parallel as well
+AVLTree::AVLTree(vector<pair<string, string>> students, unsigned threads)
+{
+    root = nullptr;
+    WorkStealingPool pool(threads);
+    size_t chunks = 4 * (size_t)pool.size();
+    size_t rows = students.size();
+
+    // sort (key, input position) packed into one word: equal keys keep their input order, so the first occurrence of a
+    // ufid leads its run (positions are 32 bits, which caps a bulk load at 4G students); a row the insert command would
+    // reject (a name with anything but letters and spaces, a ufid that is not 8 digits) gets a key above every ufid
+    const uint64_t rejectedKey = 0xFFFFFFFFULL;
+    vector<uint64_t> order(rows);
+    parallelForChunks(pool, rows, chunks, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            const pair<string, string>& student = students[i];
+            bool valid = validUfid(student.second) && validNameText(student.first);
+            uint64_t key = valid ? (uint64_t)parseEightDigits(student.second.data()) : rejectedKey;
+            order[i] = key << 32 | (uint32_t)i;
+        }
+    });
+    parallelSort(order, pool, less<uint64_t>());
+
+    // the rejected rows sort to the end, where they are cut off
+    size_t count = (size_t)(lower_bound(order.begin(), order.end(), rejectedKey << 32) - order.begin());
+
+    // duplicates: count the first occurrences in every chunk, so a prefix sum gives each chunk its output slots
+    auto firstOfKey = [&order](size_t i) { return i == 0 || (order[i] >> 32) != (order[i - 1] >> 32); };
+    vector<size_t> slots(chunks + 1, 0);
+    parallelForChunks(pool, chunks, chunks, [&](size_t chunk, size_t)
+    {
+        for (size_t i = count * chunk / chunks; i < count * (chunk + 1) / chunks; i++)
+        {
+            slots[chunk + 1] += firstOfKey(i);
+        }
+    });
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+    {
+        slots[chunk + 1] += slots[chunk];
+    }
+
+    // one node per distinct ufid, already in key order; the (name, ufid) pairs move on to the name index
+    vector<TreeNode*> nodes(slots[chunks]);
+    vector<pair<string, string>> names(slots[chunks]);
+    parallelForChunks(pool, chunks, chunks, [&](size_t chunk, size_t)
+    {
+        size_t slot = slots[chunk];
+        for (size_t i = count * chunk / chunks; i < count * (chunk + 1) / chunks; i++)
+        {
+            if (!firstOfKey(i))
+            {
+                continue;
+            }
+            pair<string, string>& student = students[(uint32_t)order[i]];
+            TreeNode* node = new TreeNode();
+            node->name = student.first;
+            node->ufid = student.second;
+            node->key = (int)(order[i] >> 32);
+            nodes[slot] = node;
+            names[slot++] = move(student);
+        }
+    });
+
+    // about 8 subtrees per worker, so stealing evens out the node allocation pattern each one happens to hit
+    int depth = 0;
+    while ((1u << depth) < 8 * pool.size() && depth < 20)
+    {
+        depth++;
+    }
+    root = buildBalancedParallel(nodes, 0, (int)nodes.size() - 1, nullptr, depth, pool);
+    pool.wait();
+    nameIndex.assign(names, &pool);
+
+    treeStats.add(TreeStats::Inserts, nodes.size());
+    treeStats.add(TreeStats::DuplicateInserts, count - nodes.size());
+}
+
+
+// like buildBalanced, but the shape of a range split at its middle is known from its size alone (a subtree of k nodes is
+// floor(log2 k) + 1 high, its left half never taller than its right), so the top levels are finished without waiting
+// for the subtrees below them; O(2^depth)
+AVLTree::TreeNode* AVLTree::buildBalancedParallel(vector<TreeNode*>& nodes, int low, int high, TreeNode* parent, int depth, WorkStealingPool& pool)
+{
+    if (low > high)
+    {
+        return nullptr;
+    }
+
+    int middle = low + (high - low) / 2;
+    TreeNode* node = nodes[middle];
+    node->parent = parent;
+    if (depth == 0)
+    {
+        pool.submit([this, &nodes, node, low, middle, high]
+        {
+            node->left = buildBalanced(nodes, low, middle - 1, node);
+            node->right = buildBalanced(nodes, middle + 1, high, node);
+            updateHeight(node);
+        });
+        return node;
+    }
+
+    auto heightOf = [](int size)
+    {
+        int levels = 0;
+        for (; size > 0; size >>= 1)
+        {
+            levels++;
+        }
+        return levels;
+    };
+    node->left = buildBalancedParallel(nodes, low, middle - 1, node, depth - 1, pool);
+    node->right = buildBalancedParallel(nodes, middle + 1, high, node, depth - 1, pool);
+    node->height = heightOf(high - low + 1);
+    node->balanceFactor = heightOf(middle - low) - heightOf(high - middle);
+    return node;
+}
@@ -0,0 +1,207 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "AVL.h"
+#include "Commands.h"
+using namespace std;
+
+//=====================================================//
+//         Binary Command Format Declarations          //
+//=====================================================//
+
+// Binary command stream (native byte order): "AVLC", uint32 version, uint64 record count, then one record per command:
+//   uint8 opcode (a ParsedCommand::Op, or RawLine), uint8 ufid digit count, uint8 high ufid digit count, uint8 zero,
+//   uint32 ufid, uint32 high ufid (searchRange) or int32 number (removeInorder n, searchPrefix limit),
+//   uint32 name length, name bytes (name, prefix or path; the whole text line for RawLine)
+// A ufid travels as its value plus its digit count, so "00001234" comes back as exactly that string. Text lines whose
+// operands do not fit that layout (a ufid with non-digits or more than 9 digits, as a malformed search or remove may
+// have) are carried verbatim as RawLine records and parsed as text, so every stream runs exactly like its text form.
+static const char binaryCommandMagic[4] = {'A', 'V', 'L', 'C'};
+static const uint32_t binaryCommandVersion = 1;
+static const size_t binaryHeaderSize = 16;
+static const size_t binaryRecordHeaderSize = 16;
+static const uint8_t binaryRawLine = 255;
+
+// appends the file header for "count" records to "out"
+void encodeBinaryHeader(uint64_t count, string& out);
+
+// appends the record for one text command line to "out"; O(k)
+void encodeCommandLine(const string& line, string& out);
+
+// reads the record at "cursor" into "parsed" (reusing its string buffers) and advances "cursor"; false if the bytes up
+// to "end" do not hold a whole well-formed record, or hold an insert whose name or ufid the text parser would reject; O(k)
+bool decodeCommand(const char*& cursor, const char* end, ParsedCommand& parsed);
+
+// runs every record of the binary stream "data" on "T", printing what the text commands would print; false (after
+// running the records before it) if the header or a record is malformed; O(total size)
+bool runBinaryCommands(AVLTree& T, const char* data, size_t size);
+
+
+//=====================================================//
+//         Binary Command Format Definitions           //
+//=====================================================//
+
+// returns whether "ufid" is 1 to 9 decimal digits, the form a uint32 plus a digit count reproduces exactly
+bool binaryEncodableUfid(const string& ufid)
+{
+    if (ufid.empty() || ufid.size() > 9)
+    {
+        return false;
+    }
+    for (char c : ufid)
+    {
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void encodeBinaryHeader(uint64_t count, string& out)
+{
+    char header[binaryHeaderSize];
+    memcpy(header, binaryCommandMagic, 4);
+    memcpy(header + 4, &binaryCommandVersion, 4);
+    memcpy(header + 8, &count, 8);
+    out.append(header, binaryHeaderSize);
+}
+
+
+void encodeCommandLine(const string& line, string& out)
+{
+    // a line the text parser rejects (removeInorder with no number) is an Invalid record, printing "unsuccessful" when run
+    ParsedCommand parsed = parseCommand(line);
+    bool ufidUsed = parsed.op == ParsedCommand::Insert || parsed.op == ParsedCommand::Remove
+                 || parsed.op == ParsedCommand::SearchId || parsed.op == ParsedCommand::SearchRange;
+    bool raw = (ufidUsed && !binaryEncodableUfid(parsed.ufid))
+            || (parsed.op == ParsedCommand::SearchRange && !binaryEncodableUfid(parsed.highUfid));
+
+    char header[binaryRecordHeaderSize] = {};
+    uint32_t ufid = raw || !ufidUsed ? 0 : (uint32_t)stoul(parsed.ufid);
+    uint32_t second = 0;
+    const string& name = raw ? line : parsed.name;
+    uint32_t nameLength = (uint32_t)name.size();
+    header[0] = (char)(raw ? binaryRawLine : (uint8_t)parsed.op);
+    header[1] = (char)(raw || !ufidUsed ? 0 : parsed.ufid.size());
+    if (!raw && parsed.op == ParsedCommand::SearchRange)
+    {
+        header[2] = (char)parsed.highUfid.size();
+        second = (uint32_t)stoul(parsed.highUfid);
+    }
+    else if (!raw)
+    {
+        memcpy(&second, &parsed.number, 4);
+    }
+    memcpy(header + 4, &ufid, 4);
+    memcpy(header + 8, &second, 4);
+    memcpy(header + 12, &nameLength, 4);
+    out.append(header, binaryRecordHeaderSize);
+    out.append(name);
+}
+
+
+// formats "value" with "digits" digits (zero padded) into "ufid", reusing its buffer; false if it does not fit or
+// "digits" is outside the 1 .. 9 the encoder writes (binaryEncodableUfid)
+bool binaryFormatUfid(uint32_t value, uint8_t digits, string& ufid)
+{
+    // checked before formatting: snprintf returns the untruncated length, so a count past the buffer would match it
+    if (digits == 0 || digits > 9)
+    {
+        return false;
+    }
+    char text[16];
+    int length = snprintf(text, sizeof(text), "%0*u", (int)digits, value);
+    if (length != (int)digits)
+    {
+        return false;
+    }
+    ufid.assign(text, (size_t)length);
+    return true;
+}
+
+
+bool decodeCommand(const char*& cursor, const char* end, ParsedCommand& parsed)
+{
+    if ((size_t)(end - cursor) < binaryRecordHeaderSize)
+    {
+        return false;
+    }
+    uint8_t op = (uint8_t)cursor[0];
+    uint8_t ufidDigits = (uint8_t)cursor[1];
+    uint8_t highDigits = (uint8_t)cursor[2];
+    uint32_t ufid;
+    uint32_t second;
+    uint32_t nameLength;
+    memcpy(&ufid, cursor + 4, 4);
+    memcpy(&second, cursor + 8, 4);
+    memcpy(&nameLength, cursor + 12, 4);
+    if ((size_t)(end - cursor - binaryRecordHeaderSize) < nameLength || (op > ParsedCommand::Invalid && op != binaryRawLine))
+    {
+        return false;
+    }
+    const char* name = cursor + binaryRecordHeaderSize;
+    cursor = name + nameLength;
+
+    if (op == binaryRawLine)
+    {
+        parsed = parseCommand(string(name, nameLength));
+        return true;
+    }
+
+    parsed.op = (ParsedCommand::Op)op;
+    parsed.name.assign(name, nameLength);
+    parsed.number = -1;
+    parsed.ufid.clear();
+    parsed.highUfid.clear();
+    switch (parsed.op)
+    {
+        case ParsedCommand::Insert:
+            // the text parser only ever yields an insert with a valid name and an 8-digit ufid, and the tree trusts that
+            return ufidDigits == 8 && binaryFormatUfid(ufid, ufidDigits, parsed.ufid) && validNameText(parsed.name);
+        case ParsedCommand::Remove:
+        case ParsedCommand::SearchId:
+            return binaryFormatUfid(ufid, ufidDigits, parsed.ufid);
+        case ParsedCommand::SearchRange:
+            return binaryFormatUfid(ufid, ufidDigits, parsed.ufid) && binaryFormatUfid(second, highDigits, parsed.highUfid);
+        case ParsedCommand::RemoveInorder:
+        case ParsedCommand::SearchPrefix:
+            memcpy(&parsed.number, &second, 4);
+            return true;
+        default:
+            return true;
+    }
+}
+
+
+bool runBinaryCommands(AVLTree& T, const char* data, size_t size)
+{
+    uint32_t version;
+    uint64_t count;
+    if (size < binaryHeaderSize || memcmp(data, binaryCommandMagic, 4) != 0)
+    {
+        return false;
+    }
+    memcpy(&version, data + 4, 4);
+    memcpy(&count, data + 8, 8);
+    if (version != binaryCommandVersion)
+    {
+        return false;
+    }
+
+    const char* cursor = data + binaryHeaderSize;
+    const char* end = data + size;
+    ParsedCommand parsed;
+    for (uint64_t i = 0; i < count; i++)
+    {
+        if (!decodeCommand(cursor, end, parsed))
+        {
+            return false;
+        }
+        runCommand(T, parsed);
+    }
+    return true;
+}
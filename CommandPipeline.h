@@ -0,0 +1,135 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AVL.h"
+#include "Commands.h"
+#include "SpscRing.h"
+using namespace std;
+
+//=====================================================//
+//             CommandPipeline Declarations            //
+//=====================================================//
+
+// a run of parsed commands travelling from the parser to the executor; "last" marks the end of the input
+struct CommandBatch
+{
+    vector<ParsedCommand> commands;
+    bool last = false;
+};
+
+// everything the commands of one batch printed, travelling from the executor to the writer
+struct OutputBatch
+{
+    string text;
+    bool last = false;
+};
+
+// streambuf appending everything written to it to "text" (flushes are free, so endl costs no system call)
+class StringAppendBuffer : public streambuf
+{
+    public:
+
+        string text;
+
+    protected:
+
+        int overflow(int c) override
+        {
+            if (c != EOF)
+            {
+                text += (char)c;
+            }
+            return c;
+        }
+        streamsize xsputn(const char* data, streamsize count) override
+        {
+            text.append(data, (size_t)count);
+            return count;
+        }
+};
+
+// Runs "lineCount" command lines from "in" on "T" as a three-stage pipeline: a parser thread turns lines into
+// ParsedCommands, the calling thread (the only one touching "T") runs them with cout captured per batch, and a writer
+// thread copies each batch's output to "out". Batches of "batchSize" commands travel through two SpscRings, so the
+// output is byte for byte what executeCommand would print line by line, in the same order. While it runs, cout belongs
+// to the pipeline ("out" may be cout; the writer uses the stream buffer cout had when the pipeline started).
+void runPipelined(AVLTree& T, istream& in, long long lineCount, ostream& out, size_t batchSize = 256);
+
+
+//=====================================================//
+//          CommandPipeline Function Definitions       //
+//=====================================================//
+
+void runPipelined(AVLTree& T, istream& in, long long lineCount, ostream& out, size_t batchSize)
+{
+    // a few batches in flight are enough to keep every stage busy; more would only hold memory
+    SpscRing<CommandBatch> commands(16);
+    SpscRing<OutputBatch> outputs(16);
+    streambuf* target = out.rdbuf();
+
+    // cin is tied to cout: left tied, every getline on the parser thread would flush cout under the executor's feet
+    ostream* tied = in.tie(nullptr);
+
+    // stage 1: read and parse
+    thread parser([&]
+    {
+        CommandBatch batch;
+        batch.commands.reserve(batchSize);
+        string line;
+        for (long long i = 0; i < lineCount; i++)
+        {
+            getline(in, line);
+            batch.commands.push_back(parseCommand(line));
+            if (batch.commands.size() == batchSize)
+            {
+                commands.push(move(batch));
+                batch = CommandBatch();
+                batch.commands.reserve(batchSize);
+            }
+        }
+        batch.last = true;
+        commands.push(move(batch));
+    });
+
+    // stage 3: write each batch's output as soon as it is ready
+    thread writer([&]
+    {
+        while (true)
+        {
+            OutputBatch batch = outputs.pop();
+            target->sputn(batch.text.data(), (streamsize)batch.text.size());
+            if (batch.last)
+            {
+                break;
+            }
+        }
+        target->pubsync();
+    });
+
+    // stage 2: execute on this thread, capturing what the tree prints
+    StringAppendBuffer capture;
+    streambuf* original = cout.rdbuf(&capture);
+    while (true)
+    {
+        CommandBatch batch = commands.pop();
+        for (const ParsedCommand& command : batch.commands)
+        {
+            runCommand(T, command);
+        }
+        OutputBatch output;
+        output.text.swap(capture.text);
+        output.last = batch.last;
+        outputs.push(move(output));
+        if (batch.last)
+        {
+            break;
+        }
+    }
+    cout.rdbuf(original);
+
+    parser.join();
+    writer.join();
+    in.tie(tied);
+}
@@ -0,0 +1,359 @@
+#pragma once
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "AVL.h"
+#include "CommandPipeline.h"
+#include "Commands.h"
+using namespace std;
+
+//=====================================================//
+//            CommandServer Class Header               //
+//=====================================================//
+
+// Serves the command language to any number of local clients over a Unix domain socket, with one thread and one
+// epoll loop owning the tree. A client sends command lines ("insert "Name" 12345678\n", no leading count); every line
+// gets back exactly the text executeCommand would print for it, followed by a single '\0' byte so the client can tell
+// where one reply ends even when it is empty or spans several lines. All lines that arrive in one epoll wakeup, from
+// every ready client, run as one batch before any reply is written, so a busy server pays one wakeup and one write per
+// client per batch rather than per command. Each client's replies come back in the order it sent its lines.
+class CommandServer
+{
+    public:
+
+        // totals since open(), for the report on shutdown
+        struct Stats
+        {
+            uint64_t clients = 0;
+            uint64_t commands = 0;
+            uint64_t batches = 0;
+            uint64_t largestBatch = 0;
+        };
+
+    private:
+
+        struct Client
+        {
+            string input;           // bytes received after the last complete line
+            string output;          // replies not yet accepted by the socket
+            bool closing = false;   // peer finished sending (or broke the line limit): close once replies are out
+            uint32_t interest = EPOLLIN | EPOLLRDHUP;   // events registered with epoll
+        };
+
+        // a client line longer than this is treated as garbage and the client is dropped
+        static const size_t maxLineLength = 1 << 20;
+
+        AVLTree& tree;
+        string socketPath;
+        int listenFd = -1;
+        int epollFd = -1;
+        int stopFd = -1;
+        unordered_map<int, Client> clients;
+        Stats totals;
+
+        void acceptClients();
+
+        // reads everything available from "fd", appending its complete lines to "batch"; false once the peer is gone
+        bool readClient(int fd, Client& client, vector<pair<int, string>>& batch);
+
+        // writes as much pending output as the socket takes, then registers for EPOLLOUT only while some is left (and for
+        // input only while the client is not closing), so no client wakes the loop for nothing; false on a write error
+        bool flushClient(int fd, Client& client);
+
+        void closeClient(int fd);
+
+    public:
+
+        CommandServer(AVLTree& tree, string socketPath) : tree(tree), socketPath(socketPath) {}
+        ~CommandServer() { close(); }
+        CommandServer(const CommandServer&) = delete;
+        CommandServer& operator=(const CommandServer&) = delete;
+
+        // binds and listens on the socket path (replacing a stale socket file); false on any system call error
+        bool open();
+
+        // runs the event loop until requestStop; returns false if epoll failed
+        bool run();
+
+        // makes run() return after its current batch; safe to call from a signal handler or another thread
+        void requestStop();
+
+        // closes every client and the listening socket, and removes the socket file
+        void close();
+
+        Stats stats() const { return totals; }
+};
+
+
+//=====================================================//
+//          CommandServer Function Definitions         //
+//=====================================================//
+
+bool CommandServer::open()
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (listenFd < 0 || epollFd < 0 || stopFd < 0)
+    {
+        close();
+        return false;
+    }
+
+    unlink(socketPath.c_str());
+    if (bind(listenFd, (sockaddr*)&address, sizeof(address)) != 0 || listen(listenFd, SOMAXCONN) != 0)
+    {
+        close();
+        return false;
+    }
+
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = stopFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &event);
+    totals = Stats();
+    return true;
+}
+
+
+void CommandServer::close()
+{
+    while (!clients.empty())
+    {
+        closeClient(clients.begin()->first);
+    }
+    if (listenFd >= 0)
+    {
+        ::close(listenFd);
+        unlink(socketPath.c_str());
+    }
+    if (epollFd >= 0)
+        ::close(epollFd);
+    if (stopFd >= 0)
+        ::close(stopFd);
+    listenFd = epollFd = stopFd = -1;
+}
+
+
+// eventfd write is async-signal-safe, and wakes epoll_wait wherever it is
+void CommandServer::requestStop()
+{
+    uint64_t one = 1;
+    if (write(stopFd, &one, sizeof(one)) < 0)
+    {
+        return;
+    }
+}
+
+
+void CommandServer::acceptClients()
+{
+    while (true)
+    {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        clients[fd] = Client();
+        totals.clients++;
+    }
+}
+
+
+bool CommandServer::readClient(int fd, Client& client, vector<pair<int, string>>& batch)
+{
+    char buffer[65536];
+    bool alive = true;
+    while (true)
+    {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received > 0)
+        {
+            client.input.append(buffer, (size_t)received);
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (received < 0 && errno == EINTR)
+            continue;
+        alive = false;
+        break;
+    }
+
+    // hand over every complete line (dropping a "\r" before the newline); keep the partial one for next time
+    size_t start = 0;
+    size_t newline;
+    while ((newline = client.input.find('\n', start)) != string::npos)
+    {
+        size_t end = newline > start && client.input[newline - 1] == '\r' ? newline - 1 : newline;
+        batch.push_back(make_pair(fd, client.input.substr(start, end - start)));
+        start = newline + 1;
+    }
+    client.input.erase(0, start);
+    if (client.input.size() > maxLineLength)
+    {
+        client.input.clear();
+        alive = false;
+    }
+    return alive;
+}
+
+
+bool CommandServer::flushClient(int fd, Client& client)
+{
+    size_t sent = 0;
+    while (sent < client.output.size())
+    {
+        ssize_t written = send(fd, client.output.data() + sent, client.output.size() - sent, MSG_NOSIGNAL);
+        if (written > 0)
+        {
+            sent += (size_t)written;
+            continue;
+        }
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        return false;
+    }
+    client.output.erase(0, sent);
+
+    uint32_t interest = (client.closing ? 0u : (uint32_t)(EPOLLIN | EPOLLRDHUP)) | (client.output.empty() ? 0u : (uint32_t)EPOLLOUT);
+    if (interest != client.interest)
+    {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = interest;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+        client.interest = interest;
+    }
+    return true;
+}
+
+
+void CommandServer::closeClient(int fd)
+{
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    clients.erase(fd);
+}
+
+
+bool CommandServer::run()
+{
+    vector<epoll_event> events(256);
+    vector<pair<int, string>> batch;
+    vector<int> touched;
+    StringAppendBuffer capture;
+
+    while (true)
+    {
+        int ready = epoll_wait(epollFd, events.data(), (int)events.size(), -1);
+        if (ready < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (ready < 0)
+        {
+            return false;
+        }
+
+        // gather the lines of every ready client before running any of them
+        bool stopping = false;
+        batch.clear();
+        touched.clear();
+        for (int e = 0; e < ready; e++)
+        {
+            int fd = events[e].data.fd;
+            if (fd == stopFd)
+            {
+                stopping = true;
+                continue;
+            }
+            if (fd == listenFd)
+            {
+                acceptClients();
+                continue;
+            }
+            auto found = clients.find(fd);
+            if (found == clients.end())
+            {
+                continue;
+            }
+            Client& client = found->second;
+            if ((events[e].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && !readClient(fd, client, batch))
+            {
+                client.closing = true;
+            }
+            touched.push_back(fd);
+        }
+
+        // run the batch with the tree's output captured, one reply per line (a malformed line parses to Invalid and is
+        // answered "unsuccessful", so no client can take down the server)
+        streambuf* original = cout.rdbuf(&capture);
+        for (const pair<int, string>& request : batch)
+        {
+            runCommand(tree, parseCommand(request.second));
+            string& output = clients[request.first].output;
+            output += capture.text;
+            output += '\0';
+            capture.text.clear();
+        }
+        cout.rdbuf(original);
+        if (!batch.empty())
+        {
+            totals.commands += batch.size();
+            totals.batches++;
+            totals.largestBatch = max<uint64_t>(totals.largestBatch, batch.size());
+        }
+
+        for (int fd : touched)
+        {
+            auto found = clients.find(fd);
+            if (found == clients.end())
+            {
+                continue;
+            }
+            Client& client = found->second;
+            if (!flushClient(fd, client) || (client.closing && client.output.empty()))
+            {
+                closeClient(fd);
+            }
+        }
+
+        if (stopping)
+        {
+            return true;
+        }
+    }
+}
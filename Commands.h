@@ -0,0 +1,381 @@
+#pragma once
+#include <cctype>
+#include <exception>
+#include <string>
+#include "AVL.h"
+#include "InputValidation.h"
+using namespace std;
+
+//=====================================================//
+//              ParsedCommand Struct Header            //
+//=====================================================//
+
+// One line of the command language after parsing and validation, ready to run on a tree without looking at the text
+// again. Lines that can never succeed (a malformed insert, a searchRange bound that is not a number or overflows a key,
+// a removeInorder n or remove / search ufid that does not convert to an int, an unknown command) parse to Invalid,
+// which just prints "unsuccessful". Parsing never throws, and a parsed command never throws when run, so every driver
+// (stdin, --pipeline, --serve, --binary) answers such a line the same way and carries on.
+struct ParsedCommand
+{
+    enum Op
+    {
+        Insert, Remove, RemoveInorder,
+        SearchId, SearchName, SearchPrefix, SearchIgnoreCase, SearchRange,
+        SaveSnapshot, LoadSnapshot, ExportInorder, Checkpoint,
+        Stats, Analyze, Compact,
+        PrintInorder, PrintPreorder, PrintPostorder, PrintLevelCount,
+        Invalid
+    };
+
+    Op op = Invalid;
+    string name;        // insert / searchName / searchIgnoreCase name, searchPrefix prefix, or snapshot / export path
+    string ufid;        // insert / remove / searchId ufid, or searchRange low bound
+    string highUfid;    // searchRange high bound
+    int number = -1;    // removeInorder n, or searchPrefix limit (-1 = no limit)
+};
+
+
+//=====================================================//
+//            Command Dispatch Definitions             //
+//=====================================================//
+
+// returns the command word of "line", splitting "search" into "searchId" / "searchName" the way executeCommand does; O(k)
+string commandType(const string& line)
+{
+    string command = line.substr(0, line.find(' '));
+    if (command == "search")
+    {
+        size_t argument = line.find(' ');
+        bool byId = argument != string::npos && argument + 1 < line.size() && isdigit((unsigned char)line[argument + 1]);
+        return byId ? "searchId" : "searchName";
+    }
+    return command;
+}
+
+
+// converts "text" as stoi does (leading digits, optional sign) into "value"; false where stoi would throw; O(k)
+bool parseInt(const string& text, int& value)
+{
+    try
+    {
+        value = stoi(text);
+        return true;
+    }
+    catch (const exception&)
+    {
+        return false;
+    }
+}
+
+
+// returns whether the tree can turn "ufid" into a key (ufidKey: the 8-digit fast path, else stoi); O(k)
+bool convertibleUfid(const string& ufid)
+{
+    int key;
+    return validUfid(ufid) || parseInt(ufid, key);
+}
+
+
+// parses and validates one line of the command language without touching any tree; never throws; O(k)
+ParsedCommand parseCommand(string line)
+{
+    ParsedCommand parsed;
+    string name;
+    string ufid;
+    string space = " ";
+
+    // stop when a space reached, set the read string as the "command" to be called in the AVL Tree
+    string command = line.substr(0, line.find(space));
+
+    //============================ INSERT NAME ID ============================= //
+    if (command == "insert")
+    {
+        // bool variables for checking if the node can be inserted or not
+        bool validName = true;
+        bool validId = true;
+
+        // erase line until just after first double quote, set name equal to the substring from line(0) until the second double quote
+        line.erase(0, line.find(space) + 2);
+        name = line.substr(0,line.find("\""));
+
+
+        // check that every character in name is a letter or space (a vector register of characters at a time)
+        if (!validNameText(name))
+        {
+            // if a character in "name" is not a letter, invalid name -> cannot insert
+            validName = false;
+        }
+        
+        // get ufid number from continuing input parsing
+        line.erase(0, name.length() + 2);
+        ufid = line.substr(0, line.find(space));
+
+        // check that ufid is exactly 8 digits (one 8-byte word test)
+        if (!validUfid(ufid))
+        {
+            // if ufid doesn't contain exactly 8 digits, invalid ufid -> cannot insert
+            validId = false;
+        }
+
+        // if input for name and ufid are valid, the node can be inserted, else the command stays Invalid ("unsuccessful")
+        if (validName && validId)
+        {
+            parsed.op = ParsedCommand::Insert;
+            parsed.name = name;
+            parsed.ufid = ufid;
+        }
+    }
+
+    //============================ REMOVE ID ============================= //
+    else if (command == "remove")
+    {
+        // erase line until the first digit of the ufid, set ufid to be the string until the next space is reached
+        line.erase(0, line.find(space) + 1);
+        ufid = line.substr(0, line.find(space));
+
+        // a ufid the tree cannot convert to a key leaves the command Invalid ("unsuccessful")
+        if (convertibleUfid(ufid))
+        {
+            parsed.op = ParsedCommand::Remove;
+            parsed.ufid = ufid;
+        }
+    }
+
+    //============================ REMOVEINORDER N ============================= //
+    else if (command == "removeInorder")
+    {
+        // erase line until the digit of n, set n to be the string until the next space is reached
+        line.erase(0, line.find(space) + 1);
+        string n = line.substr(0, line.find(space));
+
+        // a missing or out of range n leaves the command Invalid ("unsuccessful")
+        if (parseInt(n, parsed.number))
+        {
+            parsed.op = ParsedCommand::RemoveInorder;
+        }
+    }
+
+    //============================ SEARCH COMMANDS ============================= //
+    else if (command == "search")
+    {
+        // erase line until the first character after the space, set readline to be the string until the next space is reached
+        line.erase(0, line.find(space) + 1);
+        string readLine = line.substr(0, line.find(space));
+        //============================ SEARCH ID ============================= //
+        if (isdigit(readLine[0]))
+        {
+            // if first character of readLine is a digit, then we are searching for a ufid (Invalid if it overflows a key)
+            if (convertibleUfid(readLine))
+            {
+                parsed.op = ParsedCommand::SearchId;
+                parsed.ufid = readLine;
+            }
+        }
+        //============================ SEARCH NAME ============================= //
+        else
+        {   
+            line.erase(0,1);
+            // else, we are searching for a name (disregard "readLine"), set name to be the string until the next double quote is reached 
+            parsed.op = ParsedCommand::SearchName;
+            parsed.name = line.substr(0,line.find("\""));
+        }
+    }
+
+    //============================ SEARCHPREFIX "PREFIX" [LIMIT] ============================= //
+    else if (command == "searchPrefix")
+    {
+        // erase line until just after the first double quote, set prefix to be the string until the next double quote
+        line.erase(0, line.find(space) + 2);
+        string prefix = line.substr(0, line.find("\""));
+
+        // optional result limit follows the closing double quote; one too large for an int leaves the command Invalid
+        line.erase(0, prefix.length() + 1);
+        size_t limit = line.find_first_of("0123456789");
+        if (limit == string::npos || parseInt(line.substr(limit), parsed.number))
+        {
+            parsed.op = ParsedCommand::SearchPrefix;
+            parsed.name = prefix;
+        }
+    }
+
+    //============================ SEARCHIGNORECASE "NAME" ============================= //
+    else if (command == "searchIgnoreCase")
+    {
+        // erase line until just after the first double quote, set name to be the string until the next double quote
+        line.erase(0, line.find(space) + 2);
+        parsed.op = ParsedCommand::SearchIgnoreCase;
+        parsed.name = line.substr(0, line.find("\""));
+    }
+
+    //============================ SEARCHRANGE LOW HIGH ============================= //
+    else if (command == "searchRange")
+    {
+        // erase line until the first digit of the low ufid, then split the two ufids at the next space
+        line.erase(0, line.find(space) + 1);
+        string low = line.substr(0, line.find(space));
+        line.erase(0, low.length() + 1);
+        string high = line.substr(0, line.find(space));
+
+        // both bounds must be numbers that fit a key, otherwise the command stays Invalid ("unsuccessful")
+        if (!low.empty() && !high.empty() && isdigit(low[0]) && isdigit(high[0]) && convertibleUfid(low) && convertibleUfid(high))
+        {
+            parsed.op = ParsedCommand::SearchRange;
+            parsed.ufid = low;
+            parsed.highUfid = high;
+        }
+    }
+
+    //============================ SAVESNAPSHOT / LOADSNAPSHOT / EXPORTINORDER PATH ============================= //
+    else if (command == "saveSnapshot" || command == "loadSnapshot" || command == "exportInorder")
+    {
+        // erase line until the first character of the path, the path is the rest of the line
+        line.erase(0, line.find(space) + 1);
+        parsed.op = command == "saveSnapshot" ? ParsedCommand::SaveSnapshot
+                  : command == "loadSnapshot" ? ParsedCommand::LoadSnapshot : ParsedCommand::ExportInorder;
+        parsed.name = line;
+    }
+
+    //============================ COMMANDS WITHOUT ARGUMENTS ============================= //
+    else if (command == "checkpoint")
+        parsed.op = ParsedCommand::Checkpoint;
+    else if (command == "stats")
+        parsed.op = ParsedCommand::Stats;
+    else if (command == "analyze")
+        parsed.op = ParsedCommand::Analyze;
+    else if (command == "compact")
+        parsed.op = ParsedCommand::Compact;
+    else if (command == "printInorder")
+        parsed.op = ParsedCommand::PrintInorder;
+    else if (command == "printPreorder")
+        parsed.op = ParsedCommand::PrintPreorder;
+    else if (command == "printPostorder")
+        parsed.op = ParsedCommand::PrintPostorder;
+    else if (command == "printLevelCount")
+        parsed.op = ParsedCommand::PrintLevelCount;
+
+    // anything else (misspelled or invalid commands) stays Invalid
+    return parsed;
+}
+
+
+// runs one parsed command on "T", printing the result like main.cpp always has
+void runCommand(AVLTree& T, const ParsedCommand& parsed)
+{
+    switch (parsed.op)
+    {
+        case ParsedCommand::Insert:
+            // call to insert function in AVLTree class (name and ufid were validated by parseCommand)
+            T.insert(parsed.name, parsed.ufid);
+            break;
+
+        case ParsedCommand::Remove:
+            // call to remove function in AVLTree class...
+            T.remove(parsed.ufid);
+            break;
+
+        case ParsedCommand::RemoveInorder:
+            // call to removeInorder function in AVLTree class
+            T.removeInorder(parsed.number);
+            break;
+
+        case ParsedCommand::SearchId:
+            // call to searchId function in AVLTree class
+            T.searchId(parsed.ufid);
+            break;
+
+        case ParsedCommand::SearchName:
+            // call to searchName function in AVLTree class...
+            T.searchName(parsed.name);
+            break;
+
+        case ParsedCommand::SearchPrefix:
+            // call to searchNamePrefix function in AVLTree class
+            T.searchNamePrefix(parsed.name, parsed.number);
+            break;
+
+        case ParsedCommand::SearchIgnoreCase:
+            // call to searchNameIgnoreCase function in AVLTree class
+            T.searchNameIgnoreCase(parsed.name);
+            break;
+
+        case ParsedCommand::SearchRange:
+            // call to searchRange function in AVLTree class
+            T.searchRange(parsed.ufid, parsed.highUfid);
+            break;
+
+        case ParsedCommand::SaveSnapshot:
+        case ParsedCommand::LoadSnapshot:
+        {
+            // call to saveSnapshot / loadSnapshot function in AVLTree class
+            bool done = parsed.op == ParsedCommand::SaveSnapshot ? T.saveSnapshot(parsed.name) : T.loadSnapshot(parsed.name);
+            cout << (done ? T.success : T.unsuccess) << endl;
+            break;
+        }
+
+        case ParsedCommand::ExportInorder:
+        {
+            // call to exportInorder function in AVLTree class, writing the inorder names to the file on every core
+            ofstream out(parsed.name, ios::binary | ios::trunc);
+            if (out)
+            {
+                T.exportInorder(out);
+            }
+            cout << (out ? T.success : T.unsuccess) << endl;
+            break;
+        }
+
+        case ParsedCommand::Checkpoint:
+            // call to checkpoint function in AVLTree class (unsuccessful unless started with --wal)
+            cout << (T.checkpoint() ? T.success : T.unsuccess) << endl;
+            break;
+
+        case ParsedCommand::Stats:
+            // call to printStats function in AVLTree class
+            T.printStats();
+            break;
+
+        case ParsedCommand::Analyze:
+            // call to printAnalysis function in AVLTree class
+            T.printAnalysis();
+            break;
+
+        case ParsedCommand::Compact:
+            // call to compact function in AVLTree class, rebuilding the tree without its tombstones
+            T.compact();
+            cout << T.success << endl;
+            break;
+
+        case ParsedCommand::PrintInorder:
+            // call to printInorder function
+            T.printInorder();
+            break;
+
+        case ParsedCommand::PrintPreorder:
+            // call to printPreorder function
+            T.printPreorder();
+            break;
+
+        case ParsedCommand::PrintPostorder:
+            // call to printPostorder function
+            T.printPostOrder();
+            break;
+
+        case ParsedCommand::PrintLevelCount:
+            // call to printLevelCount function
+            T.printLevelCount();
+            cout << endl;
+            break;
+
+        case ParsedCommand::Invalid:
+            // print "unsuccessful" for misspelled or invalid commands
+            cout << T.unsuccess << endl;
+            break;
+    }
+}
+
+
+// parses one line of the command language and runs it on "T", printing the result like main.cpp always has
+void executeCommand(AVLTree& T, string line)
+{
+    runCommand(T, parseCommand(line));
+}
@@ -0,0 +1,92 @@
+#pragma once
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <utility>
+using namespace std;
+
+//=====================================================//
+//              Generator Class Header                 //
+//=====================================================//
+
+// Lazy sequence produced by a C++20 coroutine that co_yields values of type T. Nothing runs until the first value is
+// asked for, and the coroutine is suspended again right after every co_yield, so a caller that stops early never pays
+// for the rest of the sequence. A yielded value is only borrowed: it refers to the coroutine's own temporary and is
+// valid until the iterator is advanced. Generators are move-only and own their coroutine frame.
+template <typename T>
+class Generator
+{
+    public:
+
+        struct promise_type
+        {
+            const T* current = nullptr;
+
+            Generator get_return_object() { return Generator(coroutine_handle<promise_type>::from_promise(*this)); }
+            suspend_always initial_suspend() noexcept { return {}; }
+            suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { throw; }
+
+            // the yielded temporary lives until the coroutine resumes, so keeping its address is enough
+            suspend_always yield_value(const T& value) noexcept
+            {
+                current = &value;
+                return {};
+            }
+        };
+
+        // single-pass input iterator; compares equal to default_sentinel once the coroutine has finished
+        class iterator
+        {
+            private:
+
+                coroutine_handle<promise_type> coroutine;
+
+            public:
+
+                using iterator_category = input_iterator_tag;
+                using value_type = T;
+                using difference_type = ptrdiff_t;
+
+                explicit iterator(coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+                const T& operator*() const { return *coroutine.promise().current; }
+                const T* operator->() const { return coroutine.promise().current; }
+                iterator& operator++() { coroutine.resume(); return *this; }
+                void operator++(int) { coroutine.resume(); }
+                bool operator==(default_sentinel_t) const { return coroutine.done(); }
+        };
+
+    private:
+
+        coroutine_handle<promise_type> coroutine;
+
+        explicit Generator(coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+    public:
+
+        Generator(Generator&& other) noexcept : coroutine(exchange(other.coroutine, nullptr)) {}
+        Generator& operator=(Generator&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (coroutine)
+                    coroutine.destroy();
+                coroutine = exchange(other.coroutine, nullptr);
+            }
+            return *this;
+        }
+        ~Generator() { if (coroutine) coroutine.destroy(); }
+
+        // runs the coroutine up to its first co_yield; call once per generator
+        iterator begin()
+        {
+            coroutine.resume();
+            return iterator(coroutine);
+        }
+        default_sentinel_t end() { return default_sentinel; }
+};
+
+#endif
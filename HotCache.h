@@ -0,0 +1,132 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+//=====================================================//
+//              HotCache Class Header                  //
+//=====================================================//
+
+// Small direct-mapped cache from integer ufid to "Value" (the tree stores node pointers in it).
+// Each key has exactly one slot, picked by a multiplicative hash, so a lookup is one probe and an
+// insert simply overwrites whatever lived in the slot. The owner must erase() a key whenever the
+// value it cached stops being valid.
+template <typename Value>
+class HotCache
+{
+    private:
+
+        struct Slot
+        {
+            int key = 0;
+            bool valid = false;
+            Value value = Value();
+        };
+
+        vector<Slot> slots;
+        int shift = 64;
+
+        // maps "key" to its slot with Fibonacci hashing; O(1)
+        size_t slotOf(int key) const { return (size_t)(((uint64_t)(uint32_t)key * 0x9e3779b97f4a7c15ULL) >> shift); }
+
+    public:
+
+        // counters reported through stats()
+        struct Stats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t invalidations = 0;
+
+            double hitRate() const { return hits + misses == 0 ? 0.0 : (double)hits / (hits + misses); }
+        };
+
+        // allocates "slotCount" slots, rounded up to a power of two of at least 2 (a count of 0 disables the cache)
+        HotCache(size_t slotCount = 0) { reset(slotCount); }
+
+        // drops every cached entry and resizes the cache; O(slots)
+        void reset(size_t slotCount);
+
+        // returns true and sets "value" if "key" is cached; O(1)
+        bool find(int key, Value& value);
+
+        // caches "value" for "key", evicting the slot's previous occupant; O(1)
+        void put(int key, const Value& value);
+
+        // drops "key" if it is cached; O(1)
+        void erase(int key);
+
+        size_t capacity() const { return slots.size(); }
+        const Stats& stats() const { return stats_; }
+
+    private:
+
+        Stats stats_;
+};
+
+
+//=====================================================//
+//             HotCache Function Definitions           //
+//=====================================================//
+
+template <typename Value>
+void HotCache<Value>::reset(size_t slotCount)
+{
+    size_t size = 1;
+    shift = 64;
+    while (size < slotCount || size < 2)
+    {
+        size <<= 1;
+        shift--;
+    }
+    slots.assign(slotCount == 0 ? 0 : size, Slot());
+}
+
+
+template <typename Value>
+bool HotCache<Value>::find(int key, Value& value)
+{
+    if (slots.empty())
+    {
+        return false;
+    }
+    const Slot& slot = slots[slotOf(key)];
+    if (slot.valid && slot.key == key)
+    {
+        stats_.hits++;
+        value = slot.value;
+        return true;
+    }
+    stats_.misses++;
+    return false;
+}
+
+
+template <typename Value>
+void HotCache<Value>::put(int key, const Value& value)
+{
+    if (slots.empty())
+    {
+        return;
+    }
+    Slot& slot = slots[slotOf(key)];
+    slot.key = key;
+    slot.value = value;
+    slot.valid = true;
+}
+
+
+template <typename Value>
+void HotCache<Value>::erase(int key)
+{
+    if (slots.empty())
+    {
+        return;
+    }
+    Slot& slot = slots[slotOf(key)];
+    if (slot.valid && slot.key == key)
+    {
+        slot.valid = false;
+        stats_.invalidations++;
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+//=====================================================//
+//              IdFilter Class Header                  //
+//=====================================================//
+
+// Blocked Bloom filter over integer ufids. Every key maps to one 64-byte block (one cache line)
+// and sets "hashCount" bits inside it, so a lookup touches a single line of memory. A "no" answer is
+// exact, so searchId / remove can reject absent ufids without walking the tree. Keys cannot be
+// deleted; removed ufids keep answering "maybe" until the owner rebuilds the filter.
+class IdFilter
+{
+    private:
+
+        // one block = 8 words = 512 bits = one cache line
+        struct Block
+        {
+            uint64_t words[8];
+        };
+
+        static const int bitsPerKey = 10;
+        static const int hashCount = 6;
+
+        // std::allocator does not honour 64-byte alignment before C++17, so the blocks are carved out of a
+        // word vector with one spare block of slack, starting at its first cache line boundary
+        vector<uint64_t> storage;
+        Block* blocks = nullptr;
+        size_t blockCount = 0;
+        size_t keyCount;
+
+        // 64-bit finalizer (splitmix64) used to spread the ufid over the block and bit positions
+        static uint64_t mix(uint64_t x);
+
+    public:
+
+        // counters reported through stats()
+        struct Stats
+        {
+            uint64_t queries = 0;           // mayContain() calls
+            uint64_t negatives = 0;         // queries answered "definitely absent" (filter hits)
+            uint64_t falsePositives = 0;    // "maybe" answers the tree then failed to find
+
+            double hitRate() const { return queries == 0 ? 0.0 : (double)negatives / queries; }
+            double falsePositiveRate() const
+            {
+                return negatives + falsePositives == 0 ? 0.0 : (double)falsePositives / (negatives + falsePositives);
+            }
+        };
+
+        // sizes the filter for "expectedCount" keys at ~10 bits per key (~1% false positive rate)
+        IdFilter(size_t expectedCount = 0) { reset(expectedCount); }
+        IdFilter(const IdFilter&) = delete;
+        IdFilter& operator=(const IdFilter&) = delete;
+
+        // clears every bit and resizes for "expectedCount" keys; O(m)
+        void reset(size_t expectedCount);
+
+        // adds "key" to the filter; O(1)
+        void insert(int key);
+
+        // returns false if "key" was never inserted, true if it may have been; O(1)
+        bool mayContain(int key);
+
+        // records that a "maybe" answer turned out to be absent from the tree
+        void recordFalsePositive() { stats_.falsePositives++; }
+
+        size_t size() const { return keyCount; }
+        size_t capacity() const { return blockCount * 512 / bitsPerKey; }
+        const Stats& stats() const { return stats_; }
+
+    private:
+
+        Stats stats_;
+};
+
+
+//=====================================================//
+//             IdFilter Function Definitions           //
+//=====================================================//
+
+uint64_t IdFilter::mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+
+// allocates ceil(expectedCount * bitsPerKey / 512) zeroed blocks (at least one); O(m)
+void IdFilter::reset(size_t expectedCount)
+{
+    blockCount = (expectedCount * bitsPerKey + 511) / 512;
+    if (blockCount == 0)
+    {
+        blockCount = 1;
+    }
+    storage.assign((blockCount + 1) * 8, 0);
+    size_t misalignment = (size_t)((uintptr_t)storage.data() % 64);
+    blocks = (Block*)(storage.data() + (misalignment == 0 ? 0 : (64 - misalignment) / 8));
+    keyCount = 0;
+}
+
+
+// picks the block from the high half of the hash and sets "hashCount" bits, each taken from 9 bits of a second hash; O(1)
+void IdFilter::insert(int key)
+{
+    uint64_t hash = mix((uint32_t)key);
+    Block& block = blocks[(size_t)(((hash >> 32) * blockCount) >> 32)];
+    uint64_t bits = mix(hash);
+    for (int i = 0; i < hashCount; i++)
+    {
+        unsigned bit = (bits >> (i * 9)) & 511;
+        block.words[bit >> 6] |= 1ULL << (bit & 63);
+    }
+    keyCount++;
+}
+
+
+// checks the same bits insert() would set; any clear bit means the key is absent; O(1)
+bool IdFilter::mayContain(int key)
+{
+    stats_.queries++;
+    uint64_t hash = mix((uint32_t)key);
+    const Block& block = blocks[(size_t)(((hash >> 32) * blockCount) >> 32)];
+    uint64_t bits = mix(hash);
+    for (int i = 0; i < hashCount; i++)
+    {
+        unsigned bit = (bits >> (i * 9)) & 511;
+        if ((block.words[bit >> 6] & (1ULL << (bit & 63))) == 0)
+        {
+            stats_.negatives++;
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+//=====================================================//
+//             IdHashIndex Class Header                //
+//=====================================================//
+
+// Open-addressing hash table from integer ufid to "Value" (the tree stores node pointers in it).
+// Linear probing keeps a lookup to one or two cache lines; erase() shifts the following entries
+// back instead of leaving tombstones, so probe chains never degrade after remove-heavy runs.
+template <typename Value>
+class IdHashIndex
+{
+    private:
+
+        struct Slot
+        {
+            int key = 0;
+            bool used = false;
+            Value value = Value();
+        };
+
+        vector<Slot> slots;
+        size_t count = 0;
+        size_t mask = 0;
+
+        // home slot of "key" (Fibonacci hashing onto the power-of-two table); O(1)
+        size_t homeOf(int key) const { return (size_t)(((uint64_t)(uint32_t)key * 0x9e3779b97f4a7c15ULL) >> 32) & mask; }
+
+        // doubles the table and re-inserts every entry; O(n)
+        void grow();
+
+    public:
+
+        IdHashIndex() { clear(); }
+
+        // drops every entry and shrinks back to the initial table; O(1)
+        void clear();
+
+        // maps "key" to "value", replacing an existing mapping; amortized O(1)
+        void put(int key, const Value& value);
+
+        // returns true and sets "value" if "key" is present; expected O(1)
+        bool find(int key, Value& value) const;
+
+        // removes "key" if present, returning whether it was; expected O(1)
+        bool erase(int key);
+
+        size_t size() const { return count; }
+        size_t capacity() const { return slots.size(); }
+};
+
+
+//=====================================================//
+//           IdHashIndex Function Definitions          //
+//=====================================================//
+
+template <typename Value>
+void IdHashIndex<Value>::clear()
+{
+    slots.assign(16, Slot());
+    mask = slots.size() - 1;
+    count = 0;
+}
+
+
+template <typename Value>
+void IdHashIndex<Value>::grow()
+{
+    vector<Slot> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, Slot());
+    mask = slots.size() - 1;
+    count = 0;
+    for (const Slot& slot : old)
+    {
+        if (slot.used)
+        {
+            put(slot.key, slot.value);
+        }
+    }
+}
+
+
+// keeps the load factor at or below 1/2 so probe chains stay short
+template <typename Value>
+void IdHashIndex<Value>::put(int key, const Value& value)
+{
+    if (2 * (count + 1) > slots.size())
+    {
+        grow();
+    }
+
+    size_t i = homeOf(key);
+    while (slots[i].used && slots[i].key != key)
+    {
+        i = (i + 1) & mask;
+    }
+    if (!slots[i].used)
+    {
+        count++;
+    }
+    slots[i].key = key;
+    slots[i].value = value;
+    slots[i].used = true;
+}
+
+
+template <typename Value>
+bool IdHashIndex<Value>::find(int key, Value& value) const
+{
+    for (size_t i = homeOf(key); slots[i].used; i = (i + 1) & mask)
+    {
+        if (slots[i].key == key)
+        {
+            value = slots[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// backward-shift deletion: pull later entries of the probe chain into the hole when their home allows it
+template <typename Value>
+bool IdHashIndex<Value>::erase(int key)
+{
+    size_t i = homeOf(key);
+    while (slots[i].used && slots[i].key != key)
+    {
+        i = (i + 1) & mask;
+    }
+    if (!slots[i].used)
+    {
+        return false;
+    }
+
+    size_t hole = i;
+    for (size_t j = (hole + 1) & mask; slots[j].used; j = (j + 1) & mask)
+    {
+        // the entry at j may move into the hole only if its home is not cyclically within (hole, j]
+        size_t home = homeOf(slots[j].key);
+        if (((j - home) & mask) >= ((j - hole) & mask))
+        {
+            slots[hole] = slots[j];
+            hole = j;
+        }
+    }
+    slots[hole] = Slot();
+    count--;
+    return true;
+}
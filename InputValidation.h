@@ -0,0 +1,207 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define INPUT_VALIDATION_X86 1
+#endif
+using namespace std;
+
+//=====================================================//
+//          Input Validation Declarations              //
+//=====================================================//
+
+// Character checks for the command parser, in the C locale the driver runs in: a name may hold only letters (A-Z, a-z)
+// and whitespace (space, \t \n \v \f \r), exactly what isalpha / isspace accept there, and an insert ufid is exactly 8
+// decimal digits. Names are checked 32 bytes at a time with AVX2, 16 at a time with the SSE4.2 range compare
+// (pcmpestri), or byte by byte, picked once at run time from what the CPU supports, so the plain -O2 build lines get
+// the vector paths too. A ufid is one 8-byte word, so it is checked and converted with SWAR arithmetic on a uint64_t.
+
+// returns whether every byte of "name" is a letter or whitespace; O(k)
+bool validNameText(const string& name);
+bool validNameText(const char* data, size_t length);
+
+// the implementations validNameText chooses between (the x86 ones only where the CPU has the instructions); O(k)
+bool validNameTextScalar(const char* data, size_t length);
+#if INPUT_VALIDATION_X86
+bool validNameTextSse42(const char* data, size_t length);
+bool validNameTextAvx2(const char* data, size_t length);
+#endif
+
+// returns whether the 8 bytes at "data" are all decimal digits; O(1)
+bool eightDigits(const char* data);
+
+// returns whether "ufid" is exactly 8 decimal digits, the form insert accepts; O(1)
+bool validUfid(const string& ufid);
+
+// returns the value of the 8 decimal digits at "data" (check them with eightDigits first); O(1)
+uint32_t parseEightDigits(const char* data);
+
+// returns the integer key of "ufid": the SWAR conversion for 8 digits, stoi (and its exceptions) for anything else; O(k)
+int ufidKey(const string& ufid);
+
+
+//=====================================================//
+//          Input Validation Definitions               //
+//=====================================================//
+
+bool validNameTextScalar(const char* data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        // a letter either case ((c | 0x20) folds A-Z onto a-z), a space, or one of \t \n \v \f \r (9 .. 13)
+        unsigned char c = (unsigned char)data[i];
+        if ((unsigned char)((c | 0x20) - 'a') > 25 && c != ' ' && (unsigned char)(c - '\t') > 4)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+#if INPUT_VALIDATION_X86
+
+__attribute__((target("sse4.2")))
+bool validNameTextSse42(const char* data, size_t length)
+{
+    // four inclusive byte ranges; pcmpestri reports whether any of the first "chunk" bytes falls outside all of them
+    const __m128i ranges = _mm_setr_epi8('A', 'Z', 'a', 'z', '\t', '\r', ' ', ' ', 0, 0, 0, 0, 0, 0, 0, 0);
+    const int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_MASKED_NEGATIVE_POLARITY;
+    while (length > 0)
+    {
+        size_t chunk = length < 16 ? length : 16;
+        __m128i block;
+        if (chunk == 16)
+        {
+            block = _mm_loadu_si128((const __m128i*)data);
+        }
+        else
+        {
+            // the tail is copied out rather than loaded in place, so nothing past the end of the name is read
+            char tail[16] = {};
+            memcpy(tail, data, chunk);
+            block = _mm_loadu_si128((const __m128i*)tail);
+        }
+        if (_mm_cmpestrc(ranges, 8, block, (int)chunk, mode))
+        {
+            return false;
+        }
+        data += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+
+__attribute__((target("avx2")))
+bool validNameTextAvx2(const char* data, size_t length)
+{
+    // same test as the scalar loop on 32 bytes at once; unsigned "x <= limit" is min(x, limit) == x
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    const __m256i lowerA = _mm256_set1_epi8('a');
+    const __m256i letterSpan = _mm256_set1_epi8(25);
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i controlSpan = _mm256_set1_epi8(4);
+    const __m256i space = _mm256_set1_epi8(' ');
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i letter = _mm256_sub_epi8(_mm256_or_si256(block, caseBit), lowerA);
+        __m256i control = _mm256_sub_epi8(block, tab);
+        __m256i valid = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(letter, letterSpan), letter),
+                            _mm256_cmpeq_epi8(_mm256_min_epu8(control, controlSpan), control)),
+            _mm256_cmpeq_epi8(block, space));
+        if (_mm256_movemask_epi8(valid) != -1)
+        {
+            return false;
+        }
+    }
+
+    // fewer than 32 bytes left (every name of ordinary length): one or two 16-byte range compares
+    return validNameTextSse42(data + i, length - i);
+}
+
+#endif
+
+
+bool validNameText(const char* data, size_t length)
+{
+#if INPUT_VALIDATION_X86
+    // 2 = AVX2, 1 = SSE4.2, 0 = neither; decided on the first call
+    static const int level = []
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? 2 : __builtin_cpu_supports("sse4.2") ? 1 : 0;
+    }();
+    if (level == 2)
+    {
+        return validNameTextAvx2(data, length);
+    }
+    if (level == 1)
+    {
+        return validNameTextSse42(data, length);
+    }
+#endif
+    return validNameTextScalar(data, length);
+}
+
+
+bool validNameText(const string& name)
+{
+    return validNameText(name.data(), name.size());
+}
+
+
+bool eightDigits(const char* data)
+{
+    // a digit byte is 0x30 .. 0x39: its high nibble is 3, and adding 6 leaves the high nibble 3 (0x3A and up reach 0x40);
+    // a carry out of a bad byte can only spoil its neighbour, and the bad byte already fails
+    uint64_t word;
+    memcpy(&word, data, 8);
+    uint64_t high = word & 0xF0F0F0F0F0F0F0F0ULL;
+    uint64_t shifted = ((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4;
+    return (high | shifted) == 0x3333333333333333ULL;
+}
+
+
+bool validUfid(const string& ufid)
+{
+    return ufid.size() == 8 && eightDigits(ufid.data());
+}
+
+
+uint32_t parseEightDigits(const char* data)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // the first digit is the lowest byte; fold neighbouring digits into 2-digit values, then pairs of those into
+    // 4-digit values and the two halves into the result, with two multiplies that each combine two lanes at once
+    uint64_t word;
+    memcpy(&word, data, 8);
+    word -= 0x3030303030303030ULL;
+    word = word * 10 + (word >> 8);
+    word = ((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))
+          + ((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))) >> 32;
+    return (uint32_t)word;
+#else
+    uint32_t value = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        value = value * 10 + (uint32_t)(data[i] - '0');
+    }
+    return value;
+#endif
+}
+
+
+int ufidKey(const string& ufid)
+{
+    if (validUfid(ufid))
+    {
+        return (int)parseEightDigits(ufid.data());
+    }
+    return stoi(ufid);
+}
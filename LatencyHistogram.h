@@ -0,0 +1,203 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+using namespace std;
+
+//=====================================================//
+//              CycleClock Class Header                //
+//=====================================================//
+
+// Cheapest available timestamp: the time stamp counter where the CPU has one (a single rdtsc, no system call), otherwise
+// steady_clock nanoseconds. Ticks only become time through a ticks-per-microsecond rate measured over a real interval.
+class CycleClock
+{
+    public:
+
+        static uint64_t now()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+};
+
+
+//=====================================================//
+//           LatencyHistogram Class Header             //
+//=====================================================//
+
+// HDR-style histogram of tick counts: values below 2^SubBits get a bucket each, and every power of two above that is
+// split into 2^SubBits linear sub-buckets, so any recorded value is reported within 1 / 2^SubBits (about 3%) of its true
+// value while the whole 64-bit range fits in under 2000 counters. Recording is a bit scan and an increment.
+class LatencyHistogram
+{
+    private:
+
+        static const int SubBits = 5;
+        static const uint64_t SubCount = 1ull << SubBits;
+
+        vector<uint64_t> buckets;
+        uint64_t total = 0;
+        uint64_t maxValue = 0;
+
+        // maps "value" to its bucket; O(1)
+        static size_t bucketOf(uint64_t value);
+
+        // returns the largest value that lands in "bucket"; O(1)
+        static uint64_t highestIn(size_t bucket);
+
+    public:
+
+        LatencyHistogram() : buckets((64 - SubBits + 1) * SubCount, 0) {}
+
+        // counts one observation of "ticks"; O(1)
+        void record(uint64_t ticks);
+
+        uint64_t count() const { return total; }
+        uint64_t max() const { return maxValue; }
+
+        // returns the value at or below which a fraction "p" (0..1) of the observations fall; O(buckets)
+        uint64_t percentile(double p) const;
+};
+
+
+//=====================================================//
+//            LatencyRecorder Class Header             //
+//=====================================================//
+
+// One LatencyHistogram per command type, timed with CycleClock. The tick rate is measured between construction and
+// each report, so it needs no calibration pause up front.
+class LatencyRecorder
+{
+    private:
+
+        map<string, LatencyHistogram> histograms;
+        uint64_t startTicks;
+        chrono::steady_clock::time_point startTime;
+
+    public:
+
+        LatencyRecorder() : startTicks(CycleClock::now()), startTime(chrono::steady_clock::now()) {}
+
+        // adds one latency of "ticks" to the histogram of "command"; O(log types)
+        void record(const string& command, uint64_t ticks) { histograms[command].record(ticks); }
+
+        // ticks per microsecond over the recorder's lifetime (waits until at least 10 ms have passed, for precision)
+        double ticksPerMicro() const;
+
+        // writes a table of count and p50 / p90 / p99 / p99.9 / max microseconds for every command type to "out"
+        void print(ostream& out) const;
+};
+
+
+//=====================================================//
+//        LatencyHistogram Function Definitions        //
+//=====================================================//
+
+size_t LatencyHistogram::bucketOf(uint64_t value)
+{
+    if (value < SubCount)
+    {
+        return (size_t)value;
+    }
+    int magnitude = 63 - __builtin_clzll(value);
+    int shift = magnitude - SubBits;
+    return (size_t)((shift + 1) * SubCount + ((value >> shift) - SubCount));
+}
+
+
+uint64_t LatencyHistogram::highestIn(size_t bucket)
+{
+    if (bucket < SubCount)
+    {
+        return bucket;
+    }
+    int shift = (int)(bucket / SubCount) - 1;
+    uint64_t sub = bucket % SubCount + SubCount;
+    return ((sub + 1) << shift) - 1;
+}
+
+
+void LatencyHistogram::record(uint64_t ticks)
+{
+    buckets[bucketOf(ticks)]++;
+    total++;
+    if (ticks > maxValue)
+    {
+        maxValue = ticks;
+    }
+}
+
+
+uint64_t LatencyHistogram::percentile(double p) const
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    // walk the buckets until "p" of the observations have been passed; the exact max caps the last bucket's estimate
+    uint64_t target = (uint64_t)(p * total);
+    if (target >= total)
+    {
+        target = total - 1;
+    }
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < buckets.size(); bucket++)
+    {
+        seen += buckets[bucket];
+        if (seen > target)
+        {
+            return highestIn(bucket) < maxValue ? highestIn(bucket) : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+
+//=====================================================//
+//         LatencyRecorder Function Definitions        //
+//=====================================================//
+
+double LatencyRecorder::ticksPerMicro() const
+{
+    while (chrono::steady_clock::now() - startTime < chrono::milliseconds(10))
+    {
+    }
+    uint64_t ticks = CycleClock::now() - startTicks;
+    double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - startTime).count();
+    return ticks / micros;
+}
+
+
+void LatencyRecorder::print(ostream& out) const
+{
+    double rate = ticksPerMicro();
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+
+    out << left << setw(18) << "command" << right << setw(10) << "count" << setw(10) << "p50 us" << setw(10) << "p90 us"
+        << setw(10) << "p99 us" << setw(11) << "p99.9 us" << setw(12) << "max us" << endl;
+    out << fixed << setprecision(2);
+    for (const auto& entry : histograms)
+    {
+        const LatencyHistogram& histogram = entry.second;
+        out << left << setw(18) << entry.first << right << setw(10) << histogram.count()
+            << setw(10) << histogram.percentile(0.5) / rate << setw(10) << histogram.percentile(0.9) / rate
+            << setw(10) << histogram.percentile(0.99) / rate << setw(11) << histogram.percentile(0.999) / rate
+            << setw(12) << histogram.max() / rate << endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,565 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "InputValidation.h"
+using namespace std;
+
+//=====================================================//
+//            MappedAVLTree Class Header               //
+//=====================================================//
+
+// Disk-backed AVL tree whose nodes live in a memory-mapped file. Children are linked by slot number instead of
+// TreeNode*, so the file is valid wherever it is mapped: opening a roster only maps it, and searchId / range scans
+// run directly against the file with the OS page cache deciding what stays resident.
+//
+// "path" holds 32-byte slots: slot 0 is the file header, every other slot is a node (slot 0 doubles as the null
+// link). Names are appended to "path.names" and referenced by offset / length. Removed slots are reused through a
+// free list; removed names are not reclaimed.
+class MappedAVLTree
+{
+    private:
+
+        struct FileHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t root;
+            uint32_t count;
+            uint32_t slotsUsed;
+            uint32_t freeList;
+            uint64_t namesUsed;
+        };
+
+        struct MappedNode
+        {
+            int32_t key;
+            uint32_t left;
+            uint32_t right;
+            int16_t height;
+            uint8_t ufidLength;
+            uint8_t unused;
+            uint64_t nameOffset;
+            uint32_t nameLength;
+            uint32_t reserved;
+        };
+
+        int nodeFd = -1;
+        int nameFd = -1;
+        char* nodeMap = nullptr;
+        char* nameMap = nullptr;
+        size_t nodeMapSize = 0;
+        size_t nameMapSize = 0;
+
+        // accessors into the current mappings; never hold the result across a call that may grow a file
+        FileHeader& header() { return *(FileHeader*)nodeMap; }
+        MappedNode& node(uint32_t slot) { return ((MappedNode*)nodeMap)[slot]; }
+
+        // Helper functions to grow a file and remap it at "newSize" bytes
+        bool remap(int fd, char*& map, size_t& mapSize, size_t newSize);
+
+        // Helper functions to take a node slot (reusing freed ones) and to store a name, returning its offset
+        uint32_t allocateNode();
+        void freeNode(uint32_t slot);
+        uint64_t appendName(const string& name);
+
+        // Helper functions for heights and rotations on slot numbers
+        int height(uint32_t slot) { return slot == 0 ? 0 : node(slot).height; }
+        void updateHeight(uint32_t slot);
+        uint32_t rotateLeft(uint32_t slot);
+        uint32_t rotateRight(uint32_t slot);
+        uint32_t rebalance(uint32_t slot);
+
+        // recursive helpers returning the new root slot of the subtree they worked on
+        uint32_t insertHelper(uint32_t slot, int key, const string& name, const string& ufid, bool& inserted);
+        uint32_t removeHelper(uint32_t slot, int key, bool& removed);
+
+        // rebuilds the ufid string (zero padded to its original width) of a node
+        string ufidOf(uint32_t slot);
+
+    public:
+
+        // Success strings
+        string success = "successful";
+        string unsuccess = "unsuccessful";
+
+        MappedAVLTree() {}
+        ~MappedAVLTree() { close(); }
+        MappedAVLTree(const MappedAVLTree&) = delete;
+        MappedAVLTree& operator=(const MappedAVLTree&) = delete;
+
+        // maps the tree stored at "path" (creating an empty one if it does not exist); O(1)
+        bool open(const string& path);
+
+        // flushes dirty pages to the files and unmaps them
+        void flush();
+        void close();
+
+        // Core functions returning status instead of printing; O(log n)
+        bool insertStudent(const string& name, const string& ufid);
+        bool removeStudent(const string& ufid);
+        bool findStudent(const string& ufid, string& name);
+
+        // calls visit(ufid, name) in ufid order for every student with low <= key <= high, reading only the nodes
+        // on the boundary paths and inside the range; O(log n + k)
+        template <typename Visitor>
+        void scanRange(int low, int high, Visitor visit);
+
+        // AVLTree-style commands that print their results
+        void insert(string name, string ufid);
+        void remove(string ufid);
+        void searchId(string ufid);
+        void searchRange(string lowUfid, string highUfid);
+        void printInorder();
+        void printLevelCount();
+
+        size_t size() { return nodeMap == nullptr ? 0 : header().count; }
+        int height() { return nodeMap == nullptr ? 0 : height(header().root); }
+};
+
+
+//=====================================================//
+//          MappedAVLTree Function Definitions         //
+//=====================================================//
+
+static const char mappedMagic[4] = {'A', 'V', 'L', 'M'};
+
+
+// creates the two files with an initial size if they are empty, then maps them shared; O(1)
+bool MappedAVLTree::open(const string& path)
+{
+    close();
+    nodeFd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    nameFd = ::open((path + ".names").c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat nodeInfo;
+    struct stat nameInfo;
+    if (nodeFd < 0 || nameFd < 0 || fstat(nodeFd, &nodeInfo) != 0 || fstat(nameFd, &nameInfo) != 0)
+    {
+        close();
+        return false;
+    }
+
+    bool created = nodeInfo.st_size == 0;
+    size_t nodeSize = created ? 64 * sizeof(MappedNode) : (size_t)nodeInfo.st_size;
+    size_t nameSize = nameInfo.st_size == 0 ? 4096 : (size_t)nameInfo.st_size;
+    if (!remap(nodeFd, nodeMap, nodeMapSize, nodeSize) || !remap(nameFd, nameMap, nameMapSize, nameSize))
+    {
+        close();
+        return false;
+    }
+
+    if (created)
+    {
+        memcpy(header().magic, mappedMagic, 4);
+        header().version = 1;
+        header().root = 0;
+        header().count = 0;
+        header().slotsUsed = 1;
+        header().freeList = 0;
+        header().namesUsed = 0;
+    }
+    else if (memcmp(header().magic, mappedMagic, 4) != 0 || header().version != 1
+             || header().slotsUsed * sizeof(MappedNode) > nodeMapSize || header().namesUsed > nameMapSize)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+
+void MappedAVLTree::flush()
+{
+    if (nodeMap != nullptr)
+        msync(nodeMap, nodeMapSize, MS_SYNC);
+    if (nameMap != nullptr)
+        msync(nameMap, nameMapSize, MS_SYNC);
+}
+
+
+void MappedAVLTree::close()
+{
+    flush();
+    if (nodeMap != nullptr)
+        munmap(nodeMap, nodeMapSize);
+    if (nameMap != nullptr)
+        munmap(nameMap, nameMapSize);
+    if (nodeFd >= 0)
+        ::close(nodeFd);
+    if (nameFd >= 0)
+        ::close(nameFd);
+    nodeMap = nameMap = nullptr;
+    nodeMapSize = nameMapSize = 0;
+    nodeFd = nameFd = -1;
+}
+
+
+// extends the file to "newSize" if it is shorter and maps it again (the mapping may move); the old mapping is only
+// dropped once the new one exists, so on failure the tree keeps working on what it had
+bool MappedAVLTree::remap(int fd, char*& map, size_t& mapSize, size_t newSize)
+{
+    struct stat info;
+    if (fstat(fd, &info) != 0 || ((size_t)info.st_size < newSize && ftruncate(fd, (off_t)newSize) != 0))
+    {
+        return false;
+    }
+    void* mapping = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    if (map != nullptr)
+    {
+        munmap(map, mapSize);
+    }
+    map = (char*)mapping;
+    mapSize = newSize;
+    return true;
+}
+
+
+// pops the free list, or takes the next unused slot, doubling the file when it is full; amortized O(1)
+uint32_t MappedAVLTree::allocateNode()
+{
+    uint32_t slot = header().freeList;
+    if (slot != 0)
+    {
+        header().freeList = node(slot).left;
+    }
+    else
+    {
+        if ((header().slotsUsed + 1) * sizeof(MappedNode) > nodeMapSize && !remap(nodeFd, nodeMap, nodeMapSize, 2 * nodeMapSize))
+        {
+            return 0;
+        }
+        slot = header().slotsUsed++;
+    }
+    memset(&node(slot), 0, sizeof(MappedNode));
+    node(slot).height = 1;
+    return slot;
+}
+
+
+// pushes "slot" onto the free list, reusing its left link; O(1)
+void MappedAVLTree::freeNode(uint32_t slot)
+{
+    node(slot).left = header().freeList;
+    header().freeList = slot;
+}
+
+
+// appends "name" to the name file, doubling it when full; amortized O(k)
+uint64_t MappedAVLTree::appendName(const string& name)
+{
+    uint64_t offset = header().namesUsed;
+    size_t needed = offset + name.size();
+    if (needed > nameMapSize)
+    {
+        size_t newSize = nameMapSize;
+        while (newSize < needed)
+            newSize *= 2;
+        if (!remap(nameFd, nameMap, nameMapSize, newSize))
+            return UINT64_MAX;
+    }
+    memcpy(nameMap + offset, name.data(), name.size());
+    header().namesUsed = needed;
+    return offset;
+}
+
+
+void MappedAVLTree::updateHeight(uint32_t slot)
+{
+    node(slot).height = (int16_t)(max(height(node(slot).left), height(node(slot).right)) + 1);
+}
+
+
+uint32_t MappedAVLTree::rotateLeft(uint32_t slot)
+{
+    uint32_t newParent = node(slot).right;
+    node(slot).right = node(newParent).left;
+    node(newParent).left = slot;
+    updateHeight(slot);
+    updateHeight(newParent);
+    return newParent;
+}
+
+
+uint32_t MappedAVLTree::rotateRight(uint32_t slot)
+{
+    uint32_t newParent = node(slot).left;
+    node(slot).left = node(newParent).right;
+    node(newParent).right = slot;
+    updateHeight(slot);
+    updateHeight(newParent);
+    return newParent;
+}
+
+
+// refreshes the height of "slot" and applies the single or double rotation its balance calls for; O(1)
+uint32_t MappedAVLTree::rebalance(uint32_t slot)
+{
+    updateHeight(slot);
+    int balance = height(node(slot).left) - height(node(slot).right);
+    if (balance > 1)
+    {
+        uint32_t left = node(slot).left;
+        if (height(node(left).left) < height(node(left).right))
+            node(slot).left = rotateLeft(left);
+        return rotateRight(slot);
+    }
+    if (balance < -1)
+    {
+        uint32_t right = node(slot).right;
+        if (height(node(right).right) < height(node(right).left))
+            node(slot).right = rotateRight(right);
+        return rotateLeft(slot);
+    }
+    return slot;
+}
+
+
+// the new node is allocated before any node reference is taken on the way back up, so a remap cannot invalidate one
+uint32_t MappedAVLTree::insertHelper(uint32_t slot, int key, const string& name, const string& ufid, bool& inserted)
+{
+    if (slot == 0)
+    {
+        uint64_t nameOffset = appendName(name);
+        uint32_t newSlot = nameOffset == UINT64_MAX ? 0 : allocateNode();
+        if (newSlot != 0)
+        {
+            node(newSlot).key = key;
+            node(newSlot).ufidLength = (uint8_t)ufid.size();
+            node(newSlot).nameOffset = nameOffset;
+            node(newSlot).nameLength = (uint32_t)name.size();
+            inserted = true;
+        }
+        return newSlot;
+    }
+
+    if (key < node(slot).key)
+    {
+        uint32_t child = insertHelper(node(slot).left, key, name, ufid, inserted);
+        node(slot).left = child;
+    }
+    else if (key > node(slot).key)
+    {
+        uint32_t child = insertHelper(node(slot).right, key, name, ufid, inserted);
+        node(slot).right = child;
+    }
+    else
+    {
+        return slot;
+    }
+    return inserted ? rebalance(slot) : slot;
+}
+
+
+uint32_t MappedAVLTree::removeHelper(uint32_t slot, int key, bool& removed)
+{
+    if (slot == 0)
+    {
+        return 0;
+    }
+
+    if (key < node(slot).key)
+    {
+        node(slot).left = removeHelper(node(slot).left, key, removed);
+    }
+    else if (key > node(slot).key)
+    {
+        node(slot).right = removeHelper(node(slot).right, key, removed);
+    }
+    else
+    {
+        removed = true;
+        uint32_t left = node(slot).left;
+        uint32_t right = node(slot).right;
+        if (left == 0 || right == 0)
+        {
+            freeNode(slot);
+            return left != 0 ? left : right;
+        }
+
+        // 2 children: copy the inorder successor's data here, then remove the successor from the right subtree
+        uint32_t successor = right;
+        while (node(successor).left != 0)
+            successor = node(successor).left;
+        node(slot).key = node(successor).key;
+        node(slot).ufidLength = node(successor).ufidLength;
+        node(slot).nameOffset = node(successor).nameOffset;
+        node(slot).nameLength = node(successor).nameLength;
+        bool ignored = false;
+        node(slot).right = removeHelper(right, node(successor).key, ignored);
+    }
+    return rebalance(slot);
+}
+
+
+string MappedAVLTree::ufidOf(uint32_t slot)
+{
+    char ufid[16];
+    int length = snprintf(ufid, sizeof(ufid), "%0*d", (int)node(slot).ufidLength, node(slot).key);
+    return string(ufid, length);
+}
+
+
+bool MappedAVLTree::insertStudent(const string& name, const string& ufid)
+{
+    if (nodeMap == nullptr)
+    {
+        return false;
+    }
+    bool inserted = false;
+    uint32_t newRoot = insertHelper(header().root, ufidKey(ufid), name, ufid, inserted);
+    header().root = newRoot;
+    if (inserted)
+    {
+        header().count++;
+    }
+    return inserted;
+}
+
+
+bool MappedAVLTree::removeStudent(const string& ufid)
+{
+    if (nodeMap == nullptr)
+    {
+        return false;
+    }
+    bool removed = false;
+    header().root = removeHelper(header().root, ufidKey(ufid), removed);
+    if (removed)
+    {
+        header().count--;
+    }
+    return removed;
+}
+
+
+// iterative descent straight through the mapping; O(log n)
+bool MappedAVLTree::findStudent(const string& ufid, string& name)
+{
+    if (nodeMap == nullptr)
+    {
+        return false;
+    }
+    int key = ufidKey(ufid);
+    uint32_t slot = header().root;
+    while (slot != 0)
+    {
+        const MappedNode& current = node(slot);
+        if (key < current.key)
+        {
+            slot = current.left;
+        }
+        else if (key > current.key)
+        {
+            slot = current.right;
+        }
+        else
+        {
+            if (ufidOf(slot) != ufid)
+                return false;
+            name.assign(nameMap + current.nameOffset, current.nameLength);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// inorder walk with an explicit stack that skips subtrees entirely outside [low, high]; O(log n + k)
+template <typename Visitor>
+void MappedAVLTree::scanRange(int low, int high, Visitor visit)
+{
+    if (nodeMap == nullptr)
+    {
+        return;
+    }
+    uint32_t stack[64];
+    int depth = 0;
+    uint32_t slot = header().root;
+    while (slot != 0 || depth > 0)
+    {
+        // go left while smaller keys can still be in range
+        while (slot != 0)
+        {
+            if (node(slot).key < low)
+            {
+                slot = node(slot).right;
+                continue;
+            }
+            stack[depth++] = slot;
+            slot = node(slot).left;
+        }
+        slot = stack[--depth];
+        if (node(slot).key > high)
+        {
+            return;
+        }
+        visit(ufidOf(slot), string(nameMap + node(slot).nameOffset, node(slot).nameLength));
+        slot = node(slot).right;
+    }
+}
+
+
+void MappedAVLTree::insert(string name, string ufid)
+{
+    cout << (insertStudent(name, ufid) ? success : unsuccess) << endl;
+}
+
+
+void MappedAVLTree::remove(string ufid)
+{
+    cout << (removeStudent(ufid) ? success : unsuccess) << endl;
+}
+
+
+void MappedAVLTree::searchId(string ufid)
+{
+    string name;
+    cout << (findStudent(ufid, name) ? name : unsuccess) << endl;
+}
+
+
+void MappedAVLTree::searchRange(string lowUfid, string highUfid)
+{
+    bool found = false;
+    scanRange(ufidKey(lowUfid), ufidKey(highUfid), [&](const string& ufid, const string& name)
+    {
+        cout << "\"" << name << "\" " << ufid << endl;
+        found = true;
+    });
+    if (!found)
+    {
+        cout << unsuccess << endl;
+    }
+}
+
+
+void MappedAVLTree::printInorder()
+{
+    bool first = true;
+    scanRange(INT32_MIN, INT32_MAX, [&](const string&, const string& name)
+    {
+        cout << (first ? "" : ", ") << name;
+        first = false;
+    });
+    if (!first)
+    {
+        cout << endl;
+    }
+}
+
+
+void MappedAVLTree::printLevelCount()
+{
+    cout << height() << endl;
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ParallelAlgorithms.h"
+using namespace std;
+
+//=====================================================//
+//              NameIndex Class Header                 //
+//=====================================================//
+
+// Sorted secondary index over the names stored in an AVLTree. Entries are keyed by the
+// case-folded name (then ufid), so every name sharing a prefix sits in one contiguous range
+// that is found with a single lower_bound instead of a full scan of the tree.
+class NameIndex
+{
+    private:
+
+        // (folded name, ufid) -> original name
+        map<pair<string, string>, string> entries;
+
+    public:
+
+        // returns "name" folded to lowercase, used as the sort key of the index; O(k)
+        static string fold(const string& name);
+
+        // adds / drops the entry for a student; O(log n)
+        void insert(const string& name, const string& ufid);
+        void erase(const string& name, const string& ufid);
+        void clear() { entries.clear(); }
+        size_t size() const { return entries.size(); }
+
+        // replaces the index with the given (name, ufid) pairs, sorting them once instead of inserting one at a time (folding
+        // and sorting on "pool" when given one); O(n log n)
+        void assign(const vector<pair<string, string>>& students, WorkStealingPool* pool = nullptr);
+
+        // returns up to "limit" (name, ufid) pairs whose name starts with "prefix", ordered by folded name
+        // then ufid; a negative limit returns every match; O(log n + k)
+        vector<pair<string, string>> matchPrefix(const string& prefix, int limit = -1, bool ignoreCase = true) const;
+
+        // returns up to "limit" (name, ufid) pairs whose name equals "name" ignoring case; O(log n + k)
+        vector<pair<string, string>> matchName(const string& name, int limit = -1) const;
+};
+
+
+//=====================================================//
+//            NameIndex Function Definitions           //
+//=====================================================//
+
+// lowercases every letter of "name"; O(k)
+string NameIndex::fold(const string& name)
+{
+    string folded = name;
+    for (char& c : folded)
+    {
+        c = (char)tolower((unsigned char)c);
+    }
+    return folded;
+}
+
+
+// adds "name"/"ufid" to the index; O(log n)
+void NameIndex::insert(const string& name, const string& ufid)
+{
+    entries[make_pair(fold(name), ufid)] = name;
+}
+
+
+// sorts the folded entries, then appends each at the end of the map with a hint so every insert is O(1); O(n log n)
+void NameIndex::assign(const vector<pair<string, string>>& students, WorkStealingPool* pool)
+{
+    typedef pair<pair<string, string>, string> Entry;
+    vector<Entry> sorted(students.size());
+    auto foldRange = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            sorted[i] = make_pair(make_pair(fold(students[i].first), students[i].second), students[i].first);
+        }
+    };
+    if (pool == nullptr)
+    {
+        foldRange(0, sorted.size());
+        sort(sorted.begin(), sorted.end());
+    }
+    else
+    {
+        parallelForChunks(*pool, sorted.size(), 4 * (size_t)pool->size(), foldRange);
+        parallelSort(sorted, *pool, less<Entry>());
+    }
+
+    entries.clear();
+    for (auto& entry : sorted)
+    {
+        entries.emplace_hint(entries.end(), move(entry.first), move(entry.second));
+    }
+}
+
+
+// removes "name"/"ufid" from the index, if present; O(log n)
+void NameIndex::erase(const string& name, const string& ufid)
+{
+    entries.erase(make_pair(fold(name), ufid));
+}
+
+
+// walks the contiguous range of folded names starting with the folded "prefix"; O(log n + k)
+vector<pair<string, string>> NameIndex::matchPrefix(const string& prefix, int limit, bool ignoreCase) const
+{
+    vector<pair<string, string>> matches;
+    string key = fold(prefix);
+
+    // the empty ufid sorts before every real ufid, so this lands on the first entry of the range
+    auto it = entries.lower_bound(make_pair(key, string()));
+    for (; it != entries.end() && (limit < 0 || (int)matches.size() < limit); ++it)
+    {
+        // stop once the folded names no longer start with the prefix
+        if (it->first.first.compare(0, key.size(), key) != 0)
+        {
+            break;
+        }
+
+        // a case sensitive query keeps only the names whose original spelling matches
+        if (!ignoreCase && it->second.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+        matches.push_back(make_pair(it->second, it->first.second));
+    }
+    return matches;
+}
+
+
+// walks the range of entries whose folded name equals the folded "name"; O(log n + k)
+vector<pair<string, string>> NameIndex::matchName(const string& name, int limit) const
+{
+    vector<pair<string, string>> matches;
+    string key = fold(name);
+
+    auto it = entries.lower_bound(make_pair(key, string()));
+    for (; it != entries.end() && it->first.first == key && (limit < 0 || (int)matches.size() < limit); ++it)
+    {
+        matches.push_back(make_pair(it->second, it->first.second));
+    }
+    return matches;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "WorkStealingPool.h"
+using namespace std;
+
+//=====================================================//
+//          Parallel Algorithm Declarations            //
+//=====================================================//
+
+// calls body(begin, end) on "chunkCount" contiguous slices of [0, count) as pool tasks and waits for all of them; O(count / threads) span
+template <typename Body>
+void parallelForChunks(WorkStealingPool& pool, size_t count, size_t chunkCount, Body body);
+
+// stable merge sort of "items" by "less" on the pool: sorts 4 runs per worker with std::stable_sort, then merges runs
+// pairwise, splitting every merge into independent pieces so each round keeps every worker busy; O(n log n / threads + n log threads)
+template <typename T, typename Compare>
+void parallelSort(vector<T>& items, WorkStealingPool& pool, Compare less);
+
+
+//=====================================================//
+//          Parallel Algorithm Definitions             //
+//=====================================================//
+
+template <typename Body>
+void parallelForChunks(WorkStealingPool& pool, size_t count, size_t chunkCount, Body body)
+{
+    chunkCount = max<size_t>(1, min(chunkCount, count));
+    for (size_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        size_t begin = count * chunk / chunkCount;
+        size_t end = count * (chunk + 1) / chunkCount;
+        pool.submit([&body, begin, end] { body(begin, end); });
+    }
+    pool.wait();
+}
+
+
+template <typename T, typename Compare>
+void parallelSort(vector<T>& items, WorkStealingPool& pool, Compare less)
+{
+    // below a few thousand items per run the merges cost more than they save
+    size_t count = items.size();
+    size_t runCount = 1;
+    while (runCount < 4 * (size_t)pool.size() && count / (2 * runCount) >= 4096)
+    {
+        runCount *= 2;
+    }
+    if (runCount == 1)
+    {
+        stable_sort(items.begin(), items.end(), less);
+        return;
+    }
+
+    vector<size_t> bounds(runCount + 1);
+    for (size_t run = 0; run <= runCount; run++)
+    {
+        bounds[run] = count * run / runCount;
+    }
+    parallelForChunks(pool, runCount, runCount, [&](size_t run, size_t)
+    {
+        stable_sort(items.begin() + bounds[run], items.begin() + bounds[run + 1], less);
+    });
+
+    // merge rounds ping-pong between "items" and "buffer"; each pair of runs is cut at evenly spaced elements of its left
+    // run and the matching lower bounds in its right run, so the pieces merge independently and still come out stable
+    // (every cut is found before any piece starts moving elements out of the source)
+    vector<T> buffer(count);
+    vector<T>* from = &items;
+    vector<T>* to = &buffer;
+    for (size_t width = 1; width < runCount; width *= 2)
+    {
+        size_t pairs = runCount / (2 * width);
+        size_t pieces = max<size_t>(1, 4 * (size_t)pool.size() / pairs);
+        vector<pair<size_t, size_t>> cuts(pairs * (pieces + 1));
+        auto source = from->begin();
+
+        parallelForChunks(pool, pairs * pieces, pairs * pieces, [&](size_t task, size_t)
+        {
+            size_t left = 2 * (task / pieces) * width;
+            size_t piece = task % pieces;
+            size_t low = bounds[left];
+            size_t middle = bounds[left + width];
+            size_t high = bounds[left + 2 * width];
+            pair<size_t, size_t>* pairCuts = &cuts[task / pieces * (pieces + 1)];
+
+            size_t leftCut = low + (middle - low) * piece / pieces;
+            size_t rightCut = piece == 0 ? middle : (size_t)(lower_bound(source + middle, source + high, source[leftCut], less) - source);
+            pairCuts[piece] = make_pair(leftCut, rightCut);
+            if (piece == pieces - 1)
+            {
+                pairCuts[pieces] = make_pair(middle, high);
+            }
+        });
+
+        parallelForChunks(pool, pairs * pieces, pairs * pieces, [&](size_t task, size_t)
+        {
+            size_t middle = bounds[2 * (task / pieces) * width + width];
+            const pair<size_t, size_t>& begin = cuts[task / pieces * (pieces + 1) + task % pieces];
+            const pair<size_t, size_t>& end = (&begin)[1];
+            merge(make_move_iterator(source + begin.first), make_move_iterator(source + end.first),
+                  make_move_iterator(source + begin.second), make_move_iterator(source + end.second),
+                  to->begin() + begin.first + (begin.second - middle), less);
+        });
+        swap(from, to);
+    }
+    if (from != &items)
+    {
+        items.swap(buffer);
+    }
+}
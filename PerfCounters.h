@@ -0,0 +1,236 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+using namespace std;
+
+//=====================================================//
+//             PerfCounters Class Header               //
+//=====================================================//
+
+// Hardware performance counters of the calling thread through perf_event_open. Every event that the kernel and CPU
+// support joins one counter group, so a single read() returns them all at one instant; events that cannot be opened
+// (no PMU in a VM, perf_event_paranoid too strict) are just reported as unavailable. Counting is user-space only.
+// When the PMU has more events than counters it multiplexes the group, which then only counts part of the time: each
+// sample carries the group's enabled and running times, and the printed counts are scaled up by enabled / running
+// (or shown as "-" if the group never got onto the PMU at all).
+class PerfCounters
+{
+    public:
+
+        enum Event { Instructions, Cycles, L1dMisses, LlcMisses, DtlbMisses, BranchMisses, PageFaults, EventCount };
+
+        // counter values at one instant (or the difference of two instants), with the time the group was enabled and the
+        // part of it that it was actually counting
+        struct Sample
+        {
+            uint64_t values[EventCount] = {};
+            uint64_t enabled = 0;
+            uint64_t running = 0;
+
+            Sample operator-(const Sample& earlier) const;
+            Sample& operator+=(const Sample& other);
+        };
+
+    private:
+
+        int leader = -1;
+        int fds[EventCount];
+        int slots[EventCount];
+        int opened = 0;
+
+        static int openEvent(uint32_t type, uint64_t config, int groupFd);
+
+    public:
+
+        PerfCounters() { for (int e = 0; e < EventCount; e++) { fds[e] = -1; slots[e] = -1; } }
+        ~PerfCounters() { close(); }
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        // opens every supported event and starts counting; returns false if none could be opened
+        bool open();
+        void close();
+
+        bool available(Event event) const { return fds[event] >= 0; }
+        static const char* eventName(Event event);
+
+        // returns the running totals of every open event (unavailable events read 0); one system call
+        Sample read() const;
+
+        // writes the column headings for printRow
+        static void printHeader(ostream& out, const string& label);
+
+        // writes "label" and each event of "total", scaled for multiplexing, divided by "operations" ("-" for unavailable
+        // events, or for all of them if the group never ran)
+        void printRow(ostream& out, const string& label, const Sample& total, uint64_t operations) const;
+};
+
+
+//=====================================================//
+//          PerfCounters Function Definitions          //
+//=====================================================//
+
+int PerfCounters::openEvent(uint32_t type, uint64_t config, int groupFd)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+
+bool PerfCounters::open()
+{
+    close();
+
+    // (type, config) of every event, in Event order
+    const uint64_t cacheRead = (uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8;
+    const uint64_t cacheMiss = (uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+    const uint32_t types[EventCount] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE,
+                                        PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE};
+    const uint64_t configs[EventCount] = {PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES,
+                                          PERF_COUNT_HW_CACHE_L1D | cacheRead | cacheMiss, PERF_COUNT_HW_CACHE_MISSES,
+                                          PERF_COUNT_HW_CACHE_DTLB | cacheRead | cacheMiss, PERF_COUNT_HW_BRANCH_MISSES,
+                                          PERF_COUNT_SW_PAGE_FAULTS};
+
+    // the first event that opens leads the group; the rest join it and are read back in the order they joined
+    for (int e = 0; e < EventCount; e++)
+    {
+        fds[e] = openEvent(types[e], configs[e], leader);
+        if (fds[e] < 0)
+        {
+            continue;
+        }
+        if (leader < 0)
+        {
+            leader = fds[e];
+        }
+        slots[e] = opened++;
+    }
+    return opened > 0;
+}
+
+
+void PerfCounters::close()
+{
+    for (int e = 0; e < EventCount; e++)
+    {
+        if (fds[e] >= 0)
+        {
+            ::close(fds[e]);
+        }
+        fds[e] = -1;
+        slots[e] = -1;
+    }
+    leader = -1;
+    opened = 0;
+}
+
+
+const char* PerfCounters::eventName(Event event)
+{
+    static const char* names[EventCount] = {"instr", "cycles", "L1d miss", "LLC miss", "dTLB miss", "br miss", "faults"};
+    return names[event];
+}
+
+
+PerfCounters::Sample PerfCounters::read() const
+{
+    Sample sample;
+    if (leader < 0)
+    {
+        return sample;
+    }
+
+    // group read layout: uint64 count, uint64 time enabled, uint64 time running, then one uint64 per member in the
+    // order they joined (the group is scheduled as a unit, so the two times cover every member)
+    uint64_t buffer[3 + EventCount];
+    if (::read(leader, buffer, sizeof(uint64_t) * (3 + opened)) <= 0)
+    {
+        return sample;
+    }
+    sample.enabled = buffer[1];
+    sample.running = buffer[2];
+    for (int e = 0; e < EventCount; e++)
+    {
+        if (slots[e] >= 0)
+        {
+            sample.values[e] = buffer[3 + slots[e]];
+        }
+    }
+    return sample;
+}
+
+
+PerfCounters::Sample PerfCounters::Sample::operator-(const Sample& earlier) const
+{
+    Sample difference;
+    for (int e = 0; e < EventCount; e++)
+    {
+        difference.values[e] = values[e] - earlier.values[e];
+    }
+    difference.enabled = enabled - earlier.enabled;
+    difference.running = running - earlier.running;
+    return difference;
+}
+
+
+PerfCounters::Sample& PerfCounters::Sample::operator+=(const Sample& other)
+{
+    for (int e = 0; e < EventCount; e++)
+    {
+        values[e] += other.values[e];
+    }
+    enabled += other.enabled;
+    running += other.running;
+    return *this;
+}
+
+
+void PerfCounters::printHeader(ostream& out, const string& label)
+{
+    out << left << setw(22) << label << right << setw(10) << "ops";
+    for (int e = 0; e < EventCount; e++)
+    {
+        out << setw(11) << eventName((Event)e);
+    }
+    out << "   (per op)" << endl;
+}
+
+
+void PerfCounters::printRow(ostream& out, const string& label, const Sample& total, uint64_t operations) const
+{
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+
+    // a multiplexed group counted for only running / enabled of the time; estimate the full count from that share
+    double scale = total.running == 0 ? 0 : (double)total.enabled / total.running;
+    out << left << setw(22) << label << right << setw(10) << operations << fixed << setprecision(2);
+    for (int e = 0; e < EventCount; e++)
+    {
+        if (!available((Event)e) || operations == 0 || total.running == 0)
+        {
+            out << setw(11) << "-";
+        }
+        else
+        {
+            out << setw(11) << (double)total.values[e] * scale / operations;
+        }
+    }
+    out << endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+using namespace std;
+
+//=====================================================//
+//               SpscRing Class Header                 //
+//=====================================================//
+
+// Bounded lock-free queue between exactly one producer thread and one consumer thread. Each side owns one index
+// (tail for the producer, head for the consumer) and publishes it with a release store; the other side reads it with an
+// acquire load, and only when its cached copy says the ring looks full / empty, so most operations touch no shared
+// cache line at all. The indices sit on separate cache lines (padding rather than alignas, which plain new does not
+// honour before C++17). push / pop spin with a yield, so the ring is for stages that stay busy, not for long idle waits.
+template <typename T>
+class SpscRing
+{
+    private:
+
+        vector<T> slots;
+        size_t mask;
+
+        char padBefore[64];
+        atomic<size_t> head;        // next slot to read; written by the consumer only
+        size_t cachedTail = 0;      // consumer's last view of tail
+        char padBetween[64];
+        atomic<size_t> tail;        // next slot to write; written by the producer only
+        size_t cachedHead = 0;      // producer's last view of head
+        char padAfter[64];
+
+    public:
+
+        // holds up to "capacity" items, rounded up to a power of two
+        explicit SpscRing(size_t capacity);
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        // producer side: moves "item" in if there is room, returns false if the ring is full; O(1)
+        bool tryPush(T& item);
+
+        // consumer side: moves the oldest item into "item", returns false if the ring is empty; O(1)
+        bool tryPop(T& item);
+
+        // blocking versions: yield until there is room / an item
+        void push(T item);
+        T pop();
+};
+
+
+//=====================================================//
+//            SpscRing Function Definitions            //
+//=====================================================//
+
+template <typename T>
+SpscRing<T>::SpscRing(size_t capacity) : head(0), tail(0)
+{
+    size_t size = 2;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+    slots.resize(size);
+    mask = size - 1;
+}
+
+
+template <typename T>
+bool SpscRing<T>::tryPush(T& item)
+{
+    size_t position = tail.load(memory_order_relaxed);
+    if (position - cachedHead > mask)
+    {
+        cachedHead = head.load(memory_order_acquire);
+        if (position - cachedHead > mask)
+        {
+            return false;
+        }
+    }
+    slots[position & mask] = move(item);
+    tail.store(position + 1, memory_order_release);
+    return true;
+}
+
+
+template <typename T>
+bool SpscRing<T>::tryPop(T& item)
+{
+    size_t position = head.load(memory_order_relaxed);
+    if (position == cachedTail)
+    {
+        cachedTail = tail.load(memory_order_acquire);
+        if (position == cachedTail)
+        {
+            return false;
+        }
+    }
+    item = move(slots[position & mask]);
+    head.store(position + 1, memory_order_release);
+    return true;
+}
+
+
+template <typename T>
+void SpscRing<T>::push(T item)
+{
+    while (!tryPush(item))
+    {
+        this_thread::yield();
+    }
+}
+
+
+template <typename T>
+T SpscRing<T>::pop()
+{
+    T item;
+    while (!tryPop(item))
+    {
+        this_thread::yield();
+    }
+    return item;
+}
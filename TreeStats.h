@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+using namespace std;
+
+//=====================================================//
+//              TreeStats Class Header                 //
+//=====================================================//
+
+// Operation counters of one AVLTree. A tree is only ever updated by one thread, so every bump is a relaxed load and
+// store rather than a locked read-modify-write (it compiles to a plain add); the atomics just let another thread read
+// a consistent-enough snapshot() while the tree is busy.
+class TreeStats
+{
+    public:
+
+        enum Counter
+        {
+            Inserts, DuplicateInserts, Removes,
+            RotateLeft, RotateRight, RotateLeftRight, RotateRightLeft,
+            Searches, SearchVisits, Compactions,
+            CounterCount
+        };
+
+        // plain copy of the counters at one moment
+        struct Snapshot
+        {
+            uint64_t inserts = 0;
+            uint64_t duplicateInserts = 0;
+            uint64_t removes = 0;
+            uint64_t rotateLeft = 0;
+            uint64_t rotateRight = 0;
+            uint64_t rotateLeftRight = 0;
+            uint64_t rotateRightLeft = 0;
+            uint64_t searches = 0;
+            uint64_t searchVisits = 0;
+            uint64_t compactions = 0;
+
+            uint64_t singleRotations() const { return rotateLeft + rotateRight; }
+            uint64_t doubleRotations() const { return rotateLeftRight + rotateRightLeft; }
+            double visitsPerSearch() const { return searches == 0 ? 0.0 : (double)searchVisits / searches; }
+        };
+
+    private:
+
+        atomic<uint64_t> counters[CounterCount];
+
+    public:
+
+        TreeStats() { reset(); }
+        TreeStats(const TreeStats&) = delete;
+        TreeStats& operator=(const TreeStats&) = delete;
+
+        // adds "amount" to "counter"; only the owning tree's thread may call this; O(1)
+        void add(Counter counter, uint64_t amount = 1)
+        {
+            counters[counter].store(counters[counter].load(memory_order_relaxed) + amount, memory_order_relaxed);
+        }
+
+        uint64_t get(Counter counter) const { return counters[counter].load(memory_order_relaxed); }
+
+        // zeroes every counter; O(1)
+        void reset();
+
+        // copies every counter; O(1)
+        Snapshot snapshot() const;
+};
+
+
+//=====================================================//
+//            TreeStats Function Definitions           //
+//=====================================================//
+
+void TreeStats::reset()
+{
+    for (atomic<uint64_t>& counter : counters)
+    {
+        counter.store(0, memory_order_relaxed);
+    }
+}
+
+
+TreeStats::Snapshot TreeStats::snapshot() const
+{
+    Snapshot copy;
+    copy.inserts = get(Inserts);
+    copy.duplicateInserts = get(DuplicateInserts);
+    copy.removes = get(Removes);
+    copy.rotateLeft = get(RotateLeft);
+    copy.rotateRight = get(RotateRight);
+    copy.rotateLeftRight = get(RotateLeftRight);
+    copy.rotateRightLeft = get(RotateRightLeft);
+    copy.searches = get(Searches);
+    copy.searchVisits = get(SearchVisits);
+    copy.compactions = get(Compactions);
+    return copy;
+}
@@ -0,0 +1,196 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+//=====================================================//
+//            WorkStealingPool Class Header            //
+//=====================================================//
+
+// Fixed set of worker threads, each owning a task deque. A worker runs its own tasks newest first (the back of its
+// deque, still warm in cache) and, once it runs dry, steals the oldest task from the front of another worker's deque,
+// so unevenly sized tasks still keep every core busy. Tasks submitted by a worker go to its own deque; tasks submitted
+// from outside are dealt round-robin. Meant for coarse tasks (a whole subtree, a chunk of an array): each task costs a
+// couple of lock acquisitions.
+class WorkStealingPool
+{
+    private:
+
+        struct Queue
+        {
+            mutex lock;
+            deque<function<void()>> tasks;
+        };
+
+        vector<unique_ptr<Queue>> queues;
+        vector<thread> workers;
+
+        // "queued" counts tasks sitting in deques (what idle workers wait for), "pending" those not yet finished (what wait() waits for)
+        mutex stateLock;
+        condition_variable workAvailable;
+        condition_variable allDone;
+        size_t queued = 0;
+        size_t pending = 0;
+        size_t nextQueue = 0;
+        bool stopping = false;
+
+        // pool and deque index of the calling thread, if it is one of a pool's workers
+        static thread_local WorkStealingPool* currentPool;
+        static thread_local size_t currentIndex;
+
+        bool take(size_t index, function<void()>& task);
+        void workerLoop(size_t index);
+
+    public:
+
+        // starts "threadCount" workers (0 = one per hardware thread)
+        explicit WorkStealingPool(unsigned threadCount = 0);
+
+        // finishes every submitted task, then stops the workers
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        // queues "task" to run on some worker; O(1)
+        void submit(function<void()> task);
+
+        // blocks until every task submitted so far (and every task those submitted) has finished; must not be called from a task
+        void wait();
+
+        unsigned size() const { return (unsigned)workers.size(); }
+};
+
+
+//=====================================================//
+//        WorkStealingPool Function Definitions        //
+//=====================================================//
+
+thread_local WorkStealingPool* WorkStealingPool::currentPool = nullptr;
+thread_local size_t WorkStealingPool::currentIndex = 0;
+
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threadCount; i++)
+    {
+        queues.push_back(unique_ptr<Queue>(new Queue()));
+    }
+    for (unsigned i = 0; i < threadCount; i++)
+    {
+        workers.push_back(thread(&WorkStealingPool::workerLoop, this, (size_t)i));
+    }
+}
+
+
+WorkStealingPool::~WorkStealingPool()
+{
+    wait();
+    {
+        lock_guard<mutex> guard(stateLock);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+
+// the deque is filled while "stateLock" is held, so a worker that sees queued > 0 finds the task once it gets there
+void WorkStealingPool::submit(function<void()> task)
+{
+    {
+        lock_guard<mutex> guard(stateLock);
+        size_t index = currentPool == this ? currentIndex : nextQueue++ % queues.size();
+        {
+            lock_guard<mutex> queueGuard(queues[index]->lock);
+            queues[index]->tasks.push_back(move(task));
+        }
+        queued++;
+        pending++;
+    }
+    workAvailable.notify_one();
+}
+
+
+void WorkStealingPool::wait()
+{
+    unique_lock<mutex> guard(stateLock);
+    allDone.wait(guard, [this] { return pending == 0; });
+}
+
+
+// pops the newest task of deque "index", or else steals the oldest task of the next non-empty deque; O(workers)
+bool WorkStealingPool::take(size_t index, function<void()>& task)
+{
+    for (size_t offset = 0; offset < queues.size(); offset++)
+    {
+        Queue& queue = *queues[(index + offset) % queues.size()];
+        lock_guard<mutex> queueGuard(queue.lock);
+        if (queue.tasks.empty())
+        {
+            continue;
+        }
+        if (offset == 0)
+        {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+
+void WorkStealingPool::workerLoop(size_t index)
+{
+    currentPool = this;
+    currentIndex = index;
+
+    while (true)
+    {
+        {
+            unique_lock<mutex> guard(stateLock);
+            workAvailable.wait(guard, [this] { return stopping || queued > 0; });
+            if (queued == 0)
+            {
+                return;
+            }
+            queued--;
+        }
+
+        // a task was reserved above, so one of the deques holds at least one task nobody else will claim
+        function<void()> task;
+        while (!take(index, task))
+        {
+        }
+        task();
+
+        bool finishedAll;
+        {
+            lock_guard<mutex> guard(stateLock);
+            finishedAll = --pending == 0;
+        }
+        if (finishedAll)
+        {
+            allDone.notify_all();
+        }
+    }
+}
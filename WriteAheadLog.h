@@ -0,0 +1,318 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+//=====================================================//
+//            WriteAheadLog Class Header               //
+//=====================================================//
+
+// Append-only redo log of the tree's successful updates. Every record is written to the file as soon as it is
+// appended (so it survives a process crash), but fdatasync only runs once per group commit window, so one disk
+// flush covers every command of the window (which is what bounds the work lost to a power failure). An append past
+// the end of the window syncs on the spot; when no append comes (the end of a burst, an idle driver), a background
+// thread syncs once the window since the first unsynced record has passed, so no record waits longer than one window.
+// A failed append leaves no part of its record behind: replay stops at the first torn record, so one left in the
+// middle would hide every record after it. If the file cannot be cut back, the log refuses appends until it is emptied.
+//
+// Record layout (native byte order): uint32 payload length, uint32 FNV-1a checksum of the payload, then the payload:
+//   uint8 op, uint8 ufid length, ufid bytes, name bytes (the rest of the payload)
+class WriteAheadLog
+{
+    public:
+
+        enum Op : uint8_t { Insert = 1, Remove = 2 };
+
+    private:
+
+        int fd = -1;
+        string path;
+        chrono::microseconds window;
+        chrono::steady_clock::time_point lastSync;
+        chrono::steady_clock::time_point dirtySince;    // when the oldest unsynced record was appended
+        off_t end = 0;                                  // file length through the last whole record
+        bool dirty = false;
+        bool failed = false;                            // a partial record could not be cut off; appends are refused
+        uint64_t appended = 0;
+        uint64_t syncs = 0;
+
+        // deadline flusher (only with a non-zero window); stateLock guards every member above once it runs
+        mutable mutex stateLock;
+        condition_variable wake;
+        thread flusher;
+        bool stopping = false;
+
+        static uint32_t checksum(const char* data, size_t length);
+
+        // sleeps until the log has been dirty for a whole window, then syncs it
+        void flushLoop();
+
+        // sync with stateLock held
+        bool syncLocked();
+
+    public:
+
+        WriteAheadLog() : window(0) {}
+        ~WriteAheadLog() { close(); }
+        WriteAheadLog(const WriteAheadLog&) = delete;
+        WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+        // opens (creating if needed) the log at "logPath" for appending; a window of 0 syncs every record
+        bool open(const string& logPath, chrono::microseconds groupCommitWindow);
+
+        // syncs anything pending and closes the file
+        void close();
+
+        bool isOpen() const { return fd >= 0; }
+
+        // appends one record, syncing if the group commit window has elapsed; returns false (with the record taken back
+        // out of the file) if it could not be written, or could not be synced when the sync was due
+        bool append(Op op, const string& ufid, const string& name = "");
+
+        // forces pending records to disk now; on failure they stay pending, so a later sync retries them
+        bool sync();
+
+        // empties the log once its records are covered by a checkpoint
+        bool truncate();
+
+        uint64_t recordsAppended() const { lock_guard<mutex> guard(stateLock); return appended; }
+        uint64_t syncCount() const { lock_guard<mutex> guard(stateLock); return syncs; }
+
+        // calls apply(op, ufid, name) for every intact record of the log at "logPath", then cuts off a torn or corrupt
+        // tail so later appends follow the last good record; returns the number of records replayed
+        template <typename Apply>
+        static uint64_t replay(const string& logPath, Apply apply);
+};
+
+
+//=====================================================//
+//         WriteAheadLog Function Definitions          //
+//=====================================================//
+
+uint32_t WriteAheadLog::checksum(const char* data, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ (uint8_t)data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+
+bool WriteAheadLog::open(const string& logPath, chrono::microseconds groupCommitWindow)
+{
+    close();
+    path = logPath;
+    window = groupCommitWindow;
+    fd = ::open(logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    end = fd >= 0 ? lseek(fd, 0, SEEK_END) : 0;
+    failed = false;
+    lastSync = chrono::steady_clock::now();
+    if (fd >= 0 && window.count() > 0)
+    {
+        stopping = false;
+        flusher = thread(&WriteAheadLog::flushLoop, this);
+    }
+    return fd >= 0;
+}
+
+
+void WriteAheadLog::close()
+{
+    if (flusher.joinable())
+    {
+        {
+            lock_guard<mutex> guard(stateLock);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+    }
+    if (fd >= 0)
+    {
+        sync();
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+
+// builds the record in one buffer so it reaches the file with a single write(); O(k)
+bool WriteAheadLog::append(Op op, const string& ufid, const string& name)
+{
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    string record(8, '\0');
+    record.push_back((char)op);
+    record.push_back((char)(uint8_t)ufid.size());
+    record.append(ufid);
+    record.append(name);
+    uint32_t length = (uint32_t)(record.size() - 8);
+    uint32_t sum = checksum(record.data() + 8, length);
+    memcpy(&record[0], &length, 4);
+    memcpy(&record[4], &sum, 4);
+
+    lock_guard<mutex> guard(stateLock);
+    if (failed)
+    {
+        return false;
+    }
+    if (::write(fd, record.data(), record.size()) != (ssize_t)record.size())
+    {
+        // cut off whatever part of the record reached the file, so the next record does not land behind a torn one
+        failed = ftruncate(fd, end) != 0;
+        return false;
+    }
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    if (!dirty)
+    {
+        // the first unsynced record starts the flusher's deadline
+        dirty = true;
+        dirtySince = now;
+        wake.notify_one();
+    }
+
+    // group commit: one fdatasync covers every record appended since the window opened; if it fails the caller does not
+    // apply the update, so its record comes back out (the older ones stay pending for the next sync)
+    if (now - lastSync >= window && !syncLocked())
+    {
+        failed = ftruncate(fd, end) != 0;
+        return false;
+    }
+    end += (off_t)record.size();
+    appended++;
+    return true;
+}
+
+
+bool WriteAheadLog::sync()
+{
+    lock_guard<mutex> guard(stateLock);
+    return syncLocked();
+}
+
+
+bool WriteAheadLog::syncLocked()
+{
+    if (fd < 0 || !dirty)
+    {
+        return true;
+    }
+    if (fdatasync(fd) != 0)
+    {
+        return false;
+    }
+    lastSync = chrono::steady_clock::now();
+    dirty = false;
+    syncs++;
+    return true;
+}
+
+
+// the flusher holds stateLock while it syncs, so appends wait at most one fdatasync for it
+void WriteAheadLog::flushLoop()
+{
+    unique_lock<mutex> guard(stateLock);
+    while (!stopping)
+    {
+        if (!dirty)
+        {
+            wake.wait(guard);
+        }
+        else if (chrono::steady_clock::now() < dirtySince + window)
+        {
+            wake.wait_until(guard, dirtySince + window);
+        }
+        else if (!syncLocked())
+        {
+            // still dirty: try again one window later rather than spinning (sync and close report the failure)
+            dirtySince = chrono::steady_clock::now();
+        }
+    }
+}
+
+
+bool WriteAheadLog::truncate()
+{
+    lock_guard<mutex> guard(stateLock);
+    if (fd < 0)
+    {
+        return false;
+    }
+    if (ftruncate(fd, 0) != 0)
+    {
+        return false;
+    }
+    end = 0;
+    failed = false;
+    dirty = fdatasync(fd) != 0;
+    return !dirty;
+}
+
+
+template <typename Apply>
+uint64_t WriteAheadLog::replay(const string& logPath, Apply apply)
+{
+    int input = ::open(logPath.c_str(), O_RDWR);
+    if (input < 0)
+    {
+        return 0;
+    }
+
+    // read the whole log; it only holds the updates since the last checkpoint
+    string data;
+    char buffer[1 << 16];
+    ssize_t got;
+    while ((got = ::read(input, buffer, sizeof(buffer))) > 0)
+    {
+        data.append(buffer, (size_t)got);
+    }
+
+    uint64_t replayed = 0;
+    size_t offset = 0;
+    while (data.size() - offset >= 8)
+    {
+        uint32_t length;
+        uint32_t sum;
+        memcpy(&length, data.data() + offset, 4);
+        memcpy(&sum, data.data() + offset + 4, 4);
+        const char* payload = data.data() + offset + 8;
+
+        // stop at a record cut short by a crash or damaged on disk
+        if (length < 2 || data.size() - offset - 8 < length || checksum(payload, length) != sum
+            || (size_t)(uint8_t)payload[1] + 2 > length)
+        {
+            break;
+        }
+
+        size_t ufidLength = (uint8_t)payload[1];
+        string ufid(payload + 2, ufidLength);
+        string name(payload + 2 + ufidLength, length - 2 - ufidLength);
+        apply((Op)payload[0], ufid, name);
+        replayed++;
+        offset += 8 + length;
+    }
+
+    // drop the torn tail so the next append starts on a record boundary
+    if (offset != data.size())
+    {
+        if (ftruncate(input, (off_t)offset) == 0)
+        {
+            fdatasync(input);
+        }
+    }
+    ::close(input);
+    return replayed;
+}
@@ -0,0 +1,774 @@
+#include "AVL.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <malloc.h>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+using namespace std;
+
+/*
+	Runs identical workloads against AVLTree and alternative containers behind one adapter interface, reporting throughput
+	per phase, heap bytes per entry and tree height (At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/backendBenchmark benchmarks/backendBenchmark.cpp && build/backendBenchmark [--perf] [students] [lookups]
+
+	Backends: AVLTree (through its public, printing API into a discarding stream), std::map (libstdc++ red-black tree),
+	a left-leaning red-black tree and a B-tree (both below, exposing their height), and std::unordered_map.
+	Every adapter receives the ufid as a string and converts it itself, the same work AVLTree does.
+	--perf adds hardware counters (L1d / LLC / dTLB / branch misses) per operation for each backend's insert, find and erase phases.
+*/
+
+//=====================================================//
+//                 Allocation Counting                 //
+//=====================================================//
+
+// live heap bytes, tracked by replacing the global allocation functions
+static size_t liveBytes = 0;
+
+void* operator new(size_t size)
+{
+	void* memory = malloc(size == 0 ? 1 : size);
+	if (memory == nullptr)
+		throw bad_alloc();
+	liveBytes += malloc_usable_size(memory);
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (memory != nullptr)
+	{
+		liveBytes -= malloc_usable_size(memory);
+		free(memory);
+	}
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+
+// streambuf that drops everything written to it
+class NullBuffer : public streambuf
+{
+	protected:
+		int overflow(int c) override { return c; }
+		streamsize xsputn(const char*, streamsize count) override { return count; }
+};
+
+
+//=====================================================//
+//            Left-Leaning Red-Black Tree              //
+//=====================================================//
+
+// Sedgewick's left-leaning red-black tree (a 2-3 tree encoded in a binary tree)
+class RedBlackTree
+{
+	private:
+		struct Node
+		{
+			int key;
+			string name;
+			Node* left = nullptr;
+			Node* right = nullptr;
+			bool red = true;
+		};
+		Node* root = nullptr;
+
+		static bool isRed(Node* node) { return node != nullptr && node->red; }
+
+		static Node* rotateLeft(Node* node)
+		{
+			Node* right = node->right;
+			node->right = right->left;
+			right->left = node;
+			right->red = node->red;
+			node->red = true;
+			return right;
+		}
+
+		static Node* rotateRight(Node* node)
+		{
+			Node* left = node->left;
+			node->left = left->right;
+			left->right = node;
+			left->red = node->red;
+			node->red = true;
+			return left;
+		}
+
+		static void flipColors(Node* node)
+		{
+			node->red = !node->red;
+			node->left->red = !node->left->red;
+			node->right->red = !node->right->red;
+		}
+
+		static Node* fixUp(Node* node)
+		{
+			if (isRed(node->right) && !isRed(node->left))
+				node = rotateLeft(node);
+			if (isRed(node->left) && isRed(node->left->left))
+				node = rotateRight(node);
+			if (isRed(node->left) && isRed(node->right))
+				flipColors(node);
+			return node;
+		}
+
+		static Node* moveRedLeft(Node* node)
+		{
+			flipColors(node);
+			if (isRed(node->right->left))
+			{
+				node->right = rotateRight(node->right);
+				node = rotateLeft(node);
+				flipColors(node);
+			}
+			return node;
+		}
+
+		static Node* moveRedRight(Node* node)
+		{
+			flipColors(node);
+			if (isRed(node->left->left))
+			{
+				node = rotateRight(node);
+				flipColors(node);
+			}
+			return node;
+		}
+
+		static Node* insert(Node* node, int key, const string& name, bool& inserted)
+		{
+			if (node == nullptr)
+			{
+				inserted = true;
+				Node* leaf = new Node();
+				leaf->key = key;
+				leaf->name = name;
+				return leaf;
+			}
+			if (key < node->key)
+				node->left = insert(node->left, key, name, inserted);
+			else if (key > node->key)
+				node->right = insert(node->right, key, name, inserted);
+			return fixUp(node);
+		}
+
+		static Node* eraseMin(Node* node)
+		{
+			if (node->left == nullptr)
+			{
+				delete node;
+				return nullptr;
+			}
+			if (!isRed(node->left) && !isRed(node->left->left))
+				node = moveRedLeft(node);
+			node->left = eraseMin(node->left);
+			return fixUp(node);
+		}
+
+		// the caller guarantees "key" is present
+		static Node* erase(Node* node, int key)
+		{
+			if (key < node->key)
+			{
+				if (!isRed(node->left) && !isRed(node->left->left))
+					node = moveRedLeft(node);
+				node->left = erase(node->left, key);
+			}
+			else
+			{
+				if (isRed(node->left))
+					node = rotateRight(node);
+				if (key == node->key && node->right == nullptr)
+				{
+					delete node;
+					return nullptr;
+				}
+				if (!isRed(node->right) && !isRed(node->right->left))
+					node = moveRedRight(node);
+				if (key == node->key)
+				{
+					Node* successor = node->right;
+					while (successor->left != nullptr)
+						successor = successor->left;
+					node->key = successor->key;
+					node->name = successor->name;
+					node->right = eraseMin(node->right);
+				}
+				else
+				{
+					node->right = erase(node->right, key);
+				}
+			}
+			return fixUp(node);
+		}
+
+		static int height(Node* node) { return node == nullptr ? 0 : 1 + max(height(node->left), height(node->right)); }
+
+		static void destroy(Node* node)
+		{
+			if (node == nullptr)
+				return;
+			destroy(node->left);
+			destroy(node->right);
+			delete node;
+		}
+
+	public:
+		RedBlackTree() = default;
+		RedBlackTree(const RedBlackTree&) = delete;
+		RedBlackTree& operator=(const RedBlackTree&) = delete;
+		~RedBlackTree() { destroy(root); }
+
+		bool insert(int key, const string& name)
+		{
+			bool inserted = false;
+			root = insert(root, key, name, inserted);
+			root->red = false;
+			return inserted;
+		}
+
+		const string* find(int key) const
+		{
+			Node* node = root;
+			while (node != nullptr)
+			{
+				if (key < node->key)
+					node = node->left;
+				else if (key > node->key)
+					node = node->right;
+				else
+					return &node->name;
+			}
+			return nullptr;
+		}
+
+		bool erase(int key)
+		{
+			if (find(key) == nullptr)
+				return false;
+			if (!isRed(root->left) && !isRed(root->right))
+				root->red = true;
+			root = erase(root, key);
+			if (root != nullptr)
+				root->red = false;
+			return true;
+		}
+
+		template <typename Visitor>
+		void forEach(Visitor visit) const
+		{
+			vector<Node*> stack;
+			Node* node = root;
+			while (node != nullptr || !stack.empty())
+			{
+				while (node != nullptr)
+				{
+					stack.push_back(node);
+					node = node->left;
+				}
+				node = stack.back();
+				stack.pop_back();
+				visit(node->key, node->name);
+				node = node->right;
+			}
+		}
+
+		int height() const { return height(root); }
+};
+
+
+//=====================================================//
+//                      B-Tree                         //
+//=====================================================//
+
+// CLRS B-tree of minimum degree "Degree": every node but the root holds Degree-1 .. 2*Degree-1 keys
+template <int Degree>
+class BTree
+{
+	private:
+		struct Node
+		{
+			int count = 0;
+			bool leaf = true;
+			int keys[2 * Degree - 1];
+			string names[2 * Degree - 1];
+			Node* children[2 * Degree];
+		};
+		Node* root = new Node();
+
+		// splits the full child i of "parent" around its median key
+		void splitChild(Node* parent, int i)
+		{
+			Node* full = parent->children[i];
+			Node* right = new Node();
+			right->leaf = full->leaf;
+			right->count = Degree - 1;
+			for (int j = 0; j < Degree - 1; j++)
+			{
+				right->keys[j] = full->keys[j + Degree];
+				right->names[j] = move(full->names[j + Degree]);
+			}
+			if (!full->leaf)
+				for (int j = 0; j < Degree; j++)
+					right->children[j] = full->children[j + Degree];
+			full->count = Degree - 1;
+
+			for (int j = parent->count; j > i; j--)
+				parent->children[j + 1] = parent->children[j];
+			parent->children[i + 1] = right;
+			for (int j = parent->count - 1; j >= i; j--)
+			{
+				parent->keys[j + 1] = parent->keys[j];
+				parent->names[j + 1] = move(parent->names[j]);
+			}
+			parent->keys[i] = full->keys[Degree - 1];
+			parent->names[i] = move(full->names[Degree - 1]);
+			parent->count++;
+		}
+
+		// moves key i of "parent" and all of child i+1 into child i
+		void merge(Node* parent, int i)
+		{
+			Node* left = parent->children[i];
+			Node* right = parent->children[i + 1];
+			left->keys[left->count] = parent->keys[i];
+			left->names[left->count] = move(parent->names[i]);
+			for (int j = 0; j < right->count; j++)
+			{
+				left->keys[left->count + 1 + j] = right->keys[j];
+				left->names[left->count + 1 + j] = move(right->names[j]);
+			}
+			if (!left->leaf)
+				for (int j = 0; j <= right->count; j++)
+					left->children[left->count + 1 + j] = right->children[j];
+			left->count += right->count + 1;
+
+			for (int j = i + 1; j < parent->count; j++)
+			{
+				parent->keys[j - 1] = parent->keys[j];
+				parent->names[j - 1] = move(parent->names[j]);
+			}
+			for (int j = i + 2; j <= parent->count; j++)
+				parent->children[j - 1] = parent->children[j];
+			parent->count--;
+			delete right;
+		}
+
+		// makes sure child i of "parent" has at least Degree keys before descending into it; returns the child to descend into
+		int fill(Node* parent, int i)
+		{
+			Node* child = parent->children[i];
+			if (child->count >= Degree)
+				return i;
+			if (i > 0 && parent->children[i - 1]->count >= Degree)
+			{
+				// borrow from the left sibling through the parent
+				Node* left = parent->children[i - 1];
+				for (int j = child->count - 1; j >= 0; j--)
+				{
+					child->keys[j + 1] = child->keys[j];
+					child->names[j + 1] = move(child->names[j]);
+				}
+				if (!child->leaf)
+					for (int j = child->count; j >= 0; j--)
+						child->children[j + 1] = child->children[j];
+				child->keys[0] = parent->keys[i - 1];
+				child->names[0] = move(parent->names[i - 1]);
+				if (!child->leaf)
+					child->children[0] = left->children[left->count];
+				parent->keys[i - 1] = left->keys[left->count - 1];
+				parent->names[i - 1] = move(left->names[left->count - 1]);
+				left->count--;
+				child->count++;
+				return i;
+			}
+			if (i < parent->count && parent->children[i + 1]->count >= Degree)
+			{
+				// borrow from the right sibling through the parent
+				Node* right = parent->children[i + 1];
+				child->keys[child->count] = parent->keys[i];
+				child->names[child->count] = move(parent->names[i]);
+				if (!child->leaf)
+					child->children[child->count + 1] = right->children[0];
+				parent->keys[i] = right->keys[0];
+				parent->names[i] = move(right->names[0]);
+				for (int j = 1; j < right->count; j++)
+				{
+					right->keys[j - 1] = right->keys[j];
+					right->names[j - 1] = move(right->names[j]);
+				}
+				if (!right->leaf)
+					for (int j = 1; j <= right->count; j++)
+						right->children[j - 1] = right->children[j];
+				right->count--;
+				child->count++;
+				return i;
+			}
+			if (i < parent->count)
+			{
+				merge(parent, i);
+				return i;
+			}
+			merge(parent, i - 1);
+			return i - 1;
+		}
+
+		bool erase(Node* node, int key)
+		{
+			int i = (int)(lower_bound(node->keys, node->keys + node->count, key) - node->keys);
+			if (i < node->count && node->keys[i] == key)
+			{
+				if (node->leaf)
+				{
+					for (int j = i + 1; j < node->count; j++)
+					{
+						node->keys[j - 1] = node->keys[j];
+						node->names[j - 1] = move(node->names[j]);
+					}
+					node->count--;
+					return true;
+				}
+				if (node->children[i]->count >= Degree)
+				{
+					// replace with the predecessor, then delete the predecessor below
+					Node* predecessor = node->children[i];
+					while (!predecessor->leaf)
+						predecessor = predecessor->children[predecessor->count];
+					node->keys[i] = predecessor->keys[predecessor->count - 1];
+					node->names[i] = predecessor->names[predecessor->count - 1];
+					return erase(node->children[i], node->keys[i]);
+				}
+				if (node->children[i + 1]->count >= Degree)
+				{
+					// replace with the successor, then delete the successor below
+					Node* successor = node->children[i + 1];
+					while (!successor->leaf)
+						successor = successor->children[0];
+					node->keys[i] = successor->keys[0];
+					node->names[i] = successor->names[0];
+					return erase(node->children[i + 1], node->keys[i]);
+				}
+				merge(node, i);
+				return erase(node->children[i], key);
+			}
+			if (node->leaf)
+				return false;
+			return erase(node->children[fill(node, i)], key);
+		}
+
+		template <typename Visitor>
+		static void forEach(Node* node, Visitor& visit)
+		{
+			for (int i = 0; i < node->count; i++)
+			{
+				if (!node->leaf)
+					forEach(node->children[i], visit);
+				visit(node->keys[i], node->names[i]);
+			}
+			if (!node->leaf)
+				forEach(node->children[node->count], visit);
+		}
+
+		static void destroy(Node* node)
+		{
+			if (!node->leaf)
+				for (int i = 0; i <= node->count; i++)
+					destroy(node->children[i]);
+			delete node;
+		}
+
+	public:
+		BTree() = default;
+		BTree(const BTree&) = delete;
+		BTree& operator=(const BTree&) = delete;
+		~BTree() { destroy(root); }
+
+		const string* find(int key) const
+		{
+			Node* node = root;
+			while (true)
+			{
+				int i = (int)(lower_bound(node->keys, node->keys + node->count, key) - node->keys);
+				if (i < node->count && node->keys[i] == key)
+					return &node->names[i];
+				if (node->leaf)
+					return nullptr;
+				node = node->children[i];
+			}
+		}
+
+		bool insert(int key, const string& name)
+		{
+			if (find(key) != nullptr)
+				return false;
+			if (root->count == 2 * Degree - 1)
+			{
+				Node* newRoot = new Node();
+				newRoot->leaf = false;
+				newRoot->children[0] = root;
+				root = newRoot;
+				splitChild(root, 0);
+			}
+			// descend, splitting full children ahead of time so the insert never has to back up
+			Node* node = root;
+			while (!node->leaf)
+			{
+				int i = (int)(lower_bound(node->keys, node->keys + node->count, key) - node->keys);
+				if (node->children[i]->count == 2 * Degree - 1)
+				{
+					splitChild(node, i);
+					if (key > node->keys[i])
+						i++;
+				}
+				node = node->children[i];
+			}
+			int i = node->count;
+			while (i > 0 && node->keys[i - 1] > key)
+			{
+				node->keys[i] = node->keys[i - 1];
+				node->names[i] = move(node->names[i - 1]);
+				i--;
+			}
+			node->keys[i] = key;
+			node->names[i] = name;
+			node->count++;
+			return true;
+		}
+
+		bool erase(int key)
+		{
+			bool erased = erase(root, key);
+			if (root->count == 0 && !root->leaf)
+			{
+				Node* oldRoot = root;
+				root = root->children[0];
+				delete oldRoot;
+			}
+			return erased;
+		}
+
+		template <typename Visitor>
+		void forEach(Visitor visit) const { forEach(root, visit); }
+
+		int height() const
+		{
+			int levels = 1;
+			for (Node* node = root; !node->leaf; node = node->children[0])
+				levels++;
+			return levels;
+		}
+};
+
+
+//=====================================================//
+//                     Adapters                        //
+//=====================================================//
+
+// AVLTree through the same public API main.cpp uses
+struct AVLAdapter
+{
+	AVLTree tree;
+	static const char* name() { return "AVLTree"; }
+	void insert(const string& ufid, const string& name) { tree.insert(name, ufid); }
+	void find(const string& ufid) { tree.searchId(ufid); }
+	void erase(const string& ufid) { tree.remove(ufid); }
+	void scan() { tree.printInorder(); }
+	int height() { return tree.height(tree.root); }
+};
+
+struct StdMapAdapter
+{
+	map<int, string> tree;
+	size_t found = 0;
+	static const char* name() { return "std::map (RB)"; }
+	void insert(const string& ufid, const string& name) { tree.emplace(stoi(ufid), name); }
+	void find(const string& ufid) { found += tree.count(stoi(ufid)); }
+	void erase(const string& ufid) { tree.erase(stoi(ufid)); }
+	void scan() { for (auto& entry : tree) found += entry.second.size(); }
+	int height() { return -1; }
+};
+
+struct RedBlackAdapter
+{
+	RedBlackTree tree;
+	size_t found = 0;
+	static const char* name() { return "LLRB tree"; }
+	void insert(const string& ufid, const string& name) { tree.insert(stoi(ufid), name); }
+	void find(const string& ufid) { found += tree.find(stoi(ufid)) != nullptr; }
+	void erase(const string& ufid) { tree.erase(stoi(ufid)); }
+	void scan() { tree.forEach([&](int, const string& name) { found += name.size(); }); }
+	int height() { return tree.height(); }
+};
+
+struct BTreeAdapter
+{
+	BTree<16> tree;
+	size_t found = 0;
+	static const char* name() { return "B-tree (t=16)"; }
+	void insert(const string& ufid, const string& name) { tree.insert(stoi(ufid), name); }
+	void find(const string& ufid) { found += tree.find(stoi(ufid)) != nullptr; }
+	void erase(const string& ufid) { tree.erase(stoi(ufid)); }
+	void scan() { tree.forEach([&](int, const string& name) { found += name.size(); }); }
+	int height() { return tree.height(); }
+};
+
+struct HashAdapter
+{
+	unordered_map<int, string> table;
+	size_t found = 0;
+	static const char* name() { return "unordered_map"; }
+	void insert(const string& ufid, const string& name) { table.emplace(stoi(ufid), name); }
+	void find(const string& ufid) { found += table.count(stoi(ufid)); }
+	void erase(const string& ufid) { table.erase(stoi(ufid)); }
+	// unordered: a sorted scan has to copy and sort the keys first
+	void scan()
+	{
+		vector<pair<int, const string*>> sorted;
+		sorted.reserve(table.size());
+		for (auto& entry : table)
+			sorted.push_back(make_pair(entry.first, &entry.second));
+		sort(sorted.begin(), sorted.end());
+		for (auto& entry : sorted)
+			found += entry.second->size();
+	}
+	int height() { return -1; }
+};
+
+
+//=====================================================//
+//                      Workload                       //
+//=====================================================//
+
+struct Workload
+{
+	vector<string> ufids;
+	vector<string> names;
+	vector<string> lookups;
+};
+
+// per-phase hardware counter rows, printed after the throughput table when --perf is given
+PerfCounters counters;
+bool countersOpen = false;
+ostringstream perfReport;
+
+double secondsSince(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+// insert everything, look up (half misses), scan in order, remove half, report; identical for every backend
+template <typename Adapter>
+void run(const Workload& workload)
+{
+	NullBuffer sink;
+	streambuf* original = cout.rdbuf(&sink);
+	size_t before = liveBytes;
+	Adapter* adapter = new Adapter();
+	size_t count = workload.ufids.size();
+
+	PerfCounters::Sample insertCounters = counters.read();
+	auto start = chrono::steady_clock::now();
+	for (size_t i = 0; i < count; i++)
+		adapter->insert(workload.ufids[i], workload.names[i]);
+	double insertSeconds = secondsSince(start);
+	insertCounters = counters.read() - insertCounters;
+	double bytesPerEntry = (double)(liveBytes - before) / count;
+	int height = adapter->height();
+
+	PerfCounters::Sample findCounters = counters.read();
+	start = chrono::steady_clock::now();
+	for (const string& ufid : workload.lookups)
+		adapter->find(ufid);
+	double findSeconds = secondsSince(start);
+	findCounters = counters.read() - findCounters;
+
+	start = chrono::steady_clock::now();
+	adapter->scan();
+	double scanSeconds = secondsSince(start);
+
+	PerfCounters::Sample eraseCounters = counters.read();
+	start = chrono::steady_clock::now();
+	for (size_t i = 0; i < count; i += 2)
+		adapter->erase(workload.ufids[i]);
+	double eraseSeconds = secondsSince(start);
+	eraseCounters = counters.read() - eraseCounters;
+	int heightAfter = adapter->height();
+	cout.rdbuf(original);
+
+	cout << left << setw(16) << Adapter::name() << right << fixed << setprecision(0)
+		 << setw(12) << count / insertSeconds << setw(12) << workload.lookups.size() / findSeconds
+		 << setw(12) << (count / 2) / eraseSeconds << setprecision(2) << setw(10) << scanSeconds * 1000
+		 << setprecision(1) << setw(10) << bytesPerEntry;
+	if (height >= 0)
+		cout << setw(8) << height << setw(8) << heightAfter << endl;
+	else
+		cout << setw(8) << "-" << setw(8) << "-" << endl;
+	delete adapter;
+
+	if (countersOpen)
+	{
+		counters.printRow(perfReport, string(Adapter::name()) + " insert", insertCounters, count);
+		counters.printRow(perfReport, string(Adapter::name()) + " find", findCounters, workload.lookups.size());
+		counters.printRow(perfReport, string(Adapter::name()) + " erase", eraseCounters, (count + 1) / 2);
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	int argument = 1;
+	if (argc > 1 && strcmp(argv[1], "--perf") == 0)
+	{
+		argument++;
+		countersOpen = counters.open();
+		if (!countersOpen)
+			cout << "perf_event_open failed; no hardware counters" << endl;
+	}
+	int count = argc > argument ? atoi(argv[argument]) : 200000;
+	int lookupCount = argc > argument + 1 ? atoi(argv[argument + 1]) : 1000000;
+	mt19937 rng(31);
+
+	Workload workload;
+	for (int i = 0; i < count; i++)
+	{
+		char ufid[16];
+		snprintf(ufid, sizeof(ufid), "%08u", (unsigned)(((uint64_t)i * 2654435761u) % 100000000u));
+		workload.ufids.push_back(ufid);
+		workload.names.push_back("Student " + to_string(rng() % 100000));
+	}
+	for (int i = 0; i < lookupCount; i++)
+	{
+		if (rng() % 2)
+			workload.lookups.push_back(workload.ufids[rng() % count]);
+		else
+			workload.lookups.push_back(to_string(10000000 + rng() % 90000000));
+	}
+
+	cout << count << " students, " << lookupCount << " lookups (half absent)" << endl;
+	cout << left << setw(16) << "backend" << right << setw(12) << "insert/s" << setw(12) << "find/s" << setw(12) << "erase/s"
+		 << setw(10) << "scan ms" << setw(10) << "B/entry" << setw(8) << "height" << setw(8) << "after" << endl;
+	run<AVLAdapter>(workload);
+	run<StdMapAdapter>(workload);
+	run<RedBlackAdapter>(workload);
+	run<BTreeAdapter>(workload);
+	run<HashAdapter>(workload);
+
+	if (countersOpen)
+	{
+		cout << endl;
+		PerfCounters::printHeader(cout, "backend phase");
+		cout << perfReport.str();
+	}
+	return 0;
+}
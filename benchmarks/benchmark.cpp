@@ -0,0 +1,265 @@
+#include "AVL.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <sys/resource.h>
+#include <sys/wait.h>
+using namespace std;
+
+/*
+	Benchmark suite for every command main.cpp dispatches to, over reproducible synthetic workloads (At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/benchmark benchmarks/benchmark.cpp && build/benchmark [--ops N] [--seed S] [--perf] [sizes...]
+
+	For each roster size (default 10000 100000) and each key distribution (sequential, random, zipf) the tree is
+	preloaded with that many students, then each mix (insert-heavy, search-heavy, mixed) runs --ops commands. Every
+	size / distribution / mix runs in its own forked process, so the reported peak RSS belongs to that run alone.
+	--perf adds hardware counters (L1d / LLC / dTLB / branch misses) per command type, read around each command outside
+	its latency timing.
+*/
+
+// streambuf that drops everything, so the commands' printing costs as little as possible and nothing reaches the terminal
+class NullBuffer : public streambuf
+{
+	protected:
+		int overflow(int c) override { return c; }
+		streamsize xsputn(const char*, streamsize count) override { return count; }
+};
+
+
+enum Command { Insert, Remove, RemoveInorder, SearchId, SearchName, PrintInorder, PrintPreorder, PrintPostorder, PrintLevelCount, CommandCount };
+const char* commandNames[CommandCount] = {"insert", "remove", "removeInorder", "searchId", "searchName", "printInorder", "printPreorder", "printPostorder", "printLevelCount"};
+
+
+// per-mille weight of each command in a mix (the O(n) commands get small weights so large rosters stay measurable)
+struct Mix
+{
+	const char* name;
+	int weights[CommandCount];
+};
+
+const Mix mixes[] = {
+	{"insert-heavy", {800, 118, 0, 80, 2, 0, 0, 0, 0}},
+	{"search-heavy", {60, 30, 0, 900, 10, 0, 0, 0, 0}},
+	{"mixed",        {300, 200, 1, 485, 5, 1, 1, 1, 6}},
+};
+
+
+// key distributions over ufid ranks 0 .. n-1
+enum Distribution { Sequential, Random, Zipf };
+const char* distributionNames[] = {"sequential", "random", "zipf"};
+
+
+// draws ufid ranks; sequential walks upward, random is uniform, zipf(0.99) favours low ranks (mapped to scattered ufids)
+class KeyGenerator
+{
+	private:
+		Distribution distribution;
+		mt19937_64 rng;
+		int limit;
+		int next = 0;
+		vector<double> cumulative;
+
+	public:
+		KeyGenerator(Distribution distribution, int limit, unsigned seed) : distribution(distribution), rng(seed), limit(limit)
+		{
+			if (distribution == Zipf)
+			{
+				cumulative.resize(limit);
+				double total = 0;
+				for (int i = 0; i < limit; i++)
+				{
+					total += 1.0 / pow(i + 1, 0.99);
+					cumulative[i] = total;
+				}
+			}
+		}
+
+		int draw()
+		{
+			if (distribution == Sequential)
+				return next++ % limit;
+			if (distribution == Random)
+				return (int)(rng() % limit);
+			double target = uniform_real_distribution<double>(0, cumulative.back())(rng);
+			return (int)(lower_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin());
+		}
+};
+
+
+// sequential ranks become consecutive ufids (sorted inserts, the rotation-heavy case); other distributions spread ranks
+// over the 8-digit ufid space with a multiply that is invertible mod 10^8, so ranks never collide
+string ufidOf(int rank, Distribution distribution)
+{
+	char ufid[16];
+	unsigned value = distribution == Sequential ? (unsigned)rank : (unsigned)(((uint64_t)rank * 2654435761u) % 100000000u);
+	snprintf(ufid, sizeof(ufid), "%08u", value);
+	return ufid;
+}
+
+string nameOf(int rank)
+{
+	static const char* first[] = {"Alex", "Brian", "Chloe", "Dana", "Eli", "Fatima", "Grace", "Hugo"};
+	static const char* last[] = {"Smith", "Lee", "Garcia", "Chen", "Patel", "Jones", "Kim", "Brown"};
+	return string(first[rank % 8]) + " " + last[(rank / 8) % 8];
+}
+
+
+// returns the p-th percentile (0..1) of the sorted latencies
+double percentile(const vector<double>& sorted, double p)
+{
+	if (sorted.empty())
+		return 0;
+	return sorted[min(sorted.size() - 1, (size_t)(p * sorted.size()))];
+}
+
+
+// preloads "size" students, runs "ops" commands of "mix" with keys from "distribution", and prints one report
+void runWorkload(int size, Distribution distribution, const Mix& mix, int ops, unsigned seed, bool perf)
+{
+	NullBuffer sink;
+	streambuf* original = cout.rdbuf(&sink);
+
+	// keys of the run come from twice the preloaded range, so about half of the searches / removes miss
+	KeyGenerator keys(distribution, 2 * size, seed);
+	mt19937 rng(seed + 1);
+	AVLTree T;
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < size; i++)
+	{
+		int rank = distribution == Sequential ? i : (int)(rng() % (2 * size));
+		T.insert(nameOf(rank), ufidOf(rank, distribution));
+	}
+	double preloadSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	vector<int> thresholds(CommandCount);
+	int total = 0;
+	for (int c = 0; c < CommandCount; c++)
+	{
+		total += mix.weights[c];
+		thresholds[c] = total;
+	}
+
+	vector<vector<double>> latencies(CommandCount);
+	PerfCounters counters;
+	bool countersOpen = perf && counters.open();
+	vector<PerfCounters::Sample> counterTotals(CommandCount);
+	auto runStart = chrono::steady_clock::now();
+	for (int i = 0; i < ops; i++)
+	{
+		int pick = (int)(rng() % total);
+		int command = (int)(upper_bound(thresholds.begin(), thresholds.end(), pick) - thresholds.begin());
+		int rank = keys.draw();
+		string ufid = ufidOf(rank, distribution);
+		string name = nameOf(rank);
+		int n = size > 0 ? (int)(rng() % size) : 0;
+
+		PerfCounters::Sample countersBefore = countersOpen ? counters.read() : PerfCounters::Sample();
+		auto opStart = chrono::steady_clock::now();
+		switch (command)
+		{
+			case Insert: T.insert(name, ufid); break;
+			case Remove: T.remove(ufid); break;
+			case RemoveInorder: T.removeInorder(n); break;
+			case SearchId: T.searchId(ufid); break;
+			case SearchName: T.searchName(name); break;
+			case PrintInorder: T.printInorder(); break;
+			case PrintPreorder: T.printPreorder(); break;
+			case PrintPostorder: T.printPostOrder(); break;
+			case PrintLevelCount: T.printLevelCount(); break;
+		}
+		latencies[command].push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - opStart).count());
+		if (countersOpen)
+			counterTotals[command] += counters.read() - countersBefore;
+	}
+	double runSeconds = chrono::duration<double>(chrono::steady_clock::now() - runStart).count();
+	cout.rdbuf(original);
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	cout << fixed << setprecision(0);
+	cout << "== size " << size << ", " << distributionNames[distribution] << ", " << mix.name << " ==" << endl;
+	cout << "preload " << size / max(preloadSeconds, 1e-9) << " inserts/s, run " << ops / runSeconds << " ops/s, peak RSS "
+		 << usage.ru_maxrss / 1024 << " MiB" << endl;
+	cout << "  " << left << setw(16) << "command" << right << setw(9) << "count" << setw(12) << "ops/s"
+		 << setw(10) << "p50 us" << setw(10) << "p90 us" << setw(10) << "p99 us" << setw(11) << "p99.9 us" << setw(12) << "max us" << endl;
+	cout << setprecision(2);
+	for (int c = 0; c < CommandCount; c++)
+	{
+		vector<double>& sorted = latencies[c];
+		if (sorted.empty())
+			continue;
+		sort(sorted.begin(), sorted.end());
+		double sum = 0;
+		for (double latency : sorted)
+			sum += latency;
+		cout << "  " << left << setw(16) << commandNames[c] << right << setw(9) << sorted.size() << setw(12) << setprecision(0)
+			 << sorted.size() / (sum / 1e6) << setprecision(2) << setw(10) << percentile(sorted, 0.5) << setw(10)
+			 << percentile(sorted, 0.9) << setw(10) << percentile(sorted, 0.99) << setw(11) << percentile(sorted, 0.999)
+			 << setw(12) << sorted.back() << endl;
+	}
+
+	if (perf && !countersOpen)
+		cout << "  perf_event_open failed; no hardware counters" << endl;
+	if (countersOpen)
+	{
+		cout << "  ";
+		PerfCounters::printHeader(cout, "command");
+		for (int c = 0; c < CommandCount; c++)
+		{
+			if (latencies[c].empty())
+				continue;
+			cout << "  ";
+			counters.printRow(cout, commandNames[c], counterTotals[c], latencies[c].size());
+		}
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	int ops = 200000;
+	unsigned seed = 1;
+	bool perf = false;
+	vector<int> sizes;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc)
+			ops = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			seed = (unsigned)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--perf") == 0)
+			perf = true;
+		else
+			sizes.push_back(atoi(argv[i]));
+	}
+	if (sizes.empty())
+		sizes = {10000, 100000};
+
+	for (int size : sizes)
+	{
+		for (int distribution = Sequential; distribution <= Zipf; distribution++)
+		{
+			for (const Mix& mix : mixes)
+			{
+				// fork so every run starts from a fresh heap and reports its own peak RSS
+				cout.flush();
+				pid_t child = fork();
+				if (child == 0)
+				{
+					runWorkload(size, (Distribution)distribution, mix, ops, seed, perf);
+					cout.flush();
+					_exit(0);
+				}
+				int status = 0;
+				waitpid(child, &status, 0);
+			}
+		}
+	}
+	return 0;
+}
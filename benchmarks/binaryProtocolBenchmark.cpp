@@ -0,0 +1,135 @@
+#include "AVL.h"
+#include "BinaryCommands.h"
+#include "Commands.h"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sstream>
+using namespace std;
+
+/*
+	Commands per second of the text command format against the binary one, for decoding alone and for decoding plus
+	running on a tree (At the repository root):
+		g++ -std=c++14 -O2 -pthread -I. -o build/binaryProtocolBenchmark benchmarks/binaryProtocolBenchmark.cpp && build/binaryProtocolBenchmark [commands]
+
+	The mix is 40% insert, 40% search by ufid, 15% remove and 5% invalid inserts. Command output is dropped, so the
+	end-to-end rows show parsing plus tree work without any I/O; both formats must print the same bytes.
+*/
+
+// streambuf that drops everything written to it, counting the bytes
+class CountingBuffer : public streambuf
+{
+	public:
+		size_t bytes = 0;
+
+	protected:
+		int overflow(int c) override { bytes++; return c; }
+		streamsize xsputn(const char*, streamsize count) override { bytes += count; return count; }
+};
+
+
+int main(int argc, char* argv[])
+{
+	long long count = argc > 1 ? atoll(argv[1]) : 1000000;
+
+	mt19937 rng(49);
+	unsigned keySpace = (unsigned)max(1LL, count / 10);
+	string text;
+	for (long long i = 0; i < count; i++)
+	{
+		string ufid = to_string(10000000 + rng() % keySpace);
+		unsigned pick = rng() % 100;
+		if (pick < 40)
+			text += "insert \"Student Number\" " + ufid + "\n";
+		else if (pick < 80)
+			text += "search " + ufid + "\n";
+		else if (pick < 95)
+			text += "remove " + ufid + "\n";
+		else
+			text += "insert \"Student 7\" " + ufid + "\n";
+	}
+	string binary;
+	encodeBinaryHeader((uint64_t)count, binary);
+	{
+		istringstream lines(text);
+		string line;
+		while (getline(lines, line))
+			encodeCommandLine(line, binary);
+	}
+
+	// each run returns the number of output bytes (or a checksum of the parse), so both sides can be compared
+	auto parseText = [&]()
+	{
+		size_t checksum = 0;
+		istringstream lines(text);
+		string line;
+		for (long long i = 0; i < count && getline(lines, line); i++)
+		{
+			ParsedCommand parsed = parseCommand(line);
+			checksum += parsed.op + parsed.ufid.size() + parsed.name.size();
+		}
+		return checksum;
+	};
+	auto decodeBinary = [&]()
+	{
+		size_t checksum = 0;
+		const char* cursor = binary.data() + binaryHeaderSize;
+		const char* end = binary.data() + binary.size();
+		ParsedCommand parsed;
+		for (long long i = 0; i < count && decodeCommand(cursor, end, parsed); i++)
+			checksum += parsed.op + parsed.ufid.size() + parsed.name.size();
+		return checksum;
+	};
+	auto runText = [&]()
+	{
+		CountingBuffer sink;
+		streambuf* original = cout.rdbuf(&sink);
+		AVLTree T;
+		istringstream lines(text);
+		string line;
+		for (long long i = 0; i < count && getline(lines, line); i++)
+			executeCommand(T, line);
+		cout.rdbuf(original);
+		return sink.bytes;
+	};
+	auto runBinary = [&]()
+	{
+		CountingBuffer sink;
+		streambuf* original = cout.rdbuf(&sink);
+		AVLTree T;
+		runBinaryCommands(T, binary.data(), binary.size());
+		cout.rdbuf(original);
+		return sink.bytes;
+	};
+
+	cout << left << setw(20) << "run" << right << setw(12) << "seconds" << setw(16) << "commands/s" << setw(10) << "speedup"
+		 << setw(14) << "input bytes" << endl;
+	cout << fixed;
+	bool matched = true;
+	auto compare = [&](const string& what, const function<size_t()>& textRun, const function<size_t()>& binaryRun)
+	{
+		double seconds[2];
+		size_t results[2];
+		const function<size_t()>* runs[2] = {&textRun, &binaryRun};
+		for (int format = 0; format < 2; format++)
+		{
+			auto start = chrono::steady_clock::now();
+			results[format] = (*runs[format])();
+			seconds[format] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		}
+		matched = matched && results[0] == results[1];
+		for (int format = 0; format < 2; format++)
+		{
+			cout << left << setw(20) << what + (format == 0 ? " text" : " binary") << right << setw(12) << setprecision(3)
+				 << seconds[format] << setw(16) << setprecision(0) << count / seconds[format] << setw(10) << setprecision(2)
+				 << seconds[0] / seconds[format] << setw(14) << (format == 0 ? text.size() : binary.size()) << endl;
+		}
+	};
+	compare("parse", parseText, decodeBinary);
+	compare("parse+run", runText, runBinary);
+
+	cout << (matched ? "both formats produced the same results" : "FORMATS DISAGREE") << endl;
+	return matched ? 0 : 1;
+}
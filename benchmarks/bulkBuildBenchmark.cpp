@@ -0,0 +1,87 @@
+#include "AVL.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Bulk loading an unsorted roster: one insert per student against the parallel bulk constructor at 1 .. 32 threads
+	(At the repository root):
+		g++ -std=c++14 -O2 -pthread -I. -o build/bulkBuildBenchmark benchmarks/bulkBuildBenchmark.cpp && build/bulkBuildBenchmark [size] [maxThreads]
+
+	Ufids are drawn at random from a space 1.25x the roster size, so about a fifth of the input repeats an earlier ufid
+	and has to be dropped. Every build must end with the same node count and the optimal height.
+*/
+
+// streambuf that drops everything written to it
+class NullBuffer : public streambuf
+{
+	protected:
+		int overflow(int c) override { return c; }
+		streamsize xsputn(const char*, streamsize count) override { return count; }
+};
+
+
+int main(int argc, char* argv[])
+{
+	int size = argc > 1 ? atoi(argv[1]) : 2000000;
+	unsigned maxThreads = argc > 2 ? (unsigned)atoi(argv[2]) : 32;
+
+	mt19937 rng(45);
+	unsigned keySpace = (unsigned)(size * 1.25);
+	vector<pair<string, string>> students;
+	students.reserve(size);
+	for (int i = 0; i < size; i++)
+	{
+		char ufid[16];
+		snprintf(ufid, sizeof(ufid), "%08u", 10000000 + (unsigned)(rng() % keySpace));
+		// the name spells the row number in letters, since the bulk constructor (like insert) rejects digits in names
+		string name = "Student Number ";
+		for (char digit : to_string(i))
+			name += (char)('a' + (digit - '0'));
+		students.push_back(make_pair(name, string(ufid)));
+	}
+
+	// baseline: the command path, one insert (search, link, retrace, name index insert) per student
+	NullBuffer sink;
+	streambuf* original = cout.rdbuf(&sink);
+	auto start = chrono::steady_clock::now();
+	double baseline;
+	size_t expectedNodes;
+	{
+		AVLTree T;
+		for (const auto& student : students)
+		{
+			T.insert(student.first, student.second);
+		}
+		baseline = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		expectedNodes = T.analyze().nodeCount;
+	}
+	cout.rdbuf(original);
+
+	cout << left << setw(18) << "build" << right << setw(12) << "seconds" << setw(14) << "students/s" << setw(10) << "speedup"
+		 << setw(10) << "nodes" << setw(8) << "height" << endl;
+	cout << fixed;
+	cout << left << setw(18) << "insert loop" << right << setw(12) << setprecision(3) << baseline << setw(14) << setprecision(0)
+		 << size / baseline << setw(10) << setprecision(2) << 1.0 << setw(10) << expectedNodes << setw(8) << "-" << endl;
+
+	bool matched = true;
+	for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		// the copy is the caller's business, so it stays outside the timed region
+		vector<pair<string, string>> input = students;
+		start = chrono::steady_clock::now();
+		AVLTree T(move(input), threads);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		AVLTree::Analysis report = T.analyze();
+		matched = matched && report.nodeCount == expectedNodes && report.height == report.optimalHeight;
+		cout << left << setw(18) << "bulk x" + to_string(threads) << right << setw(12) << setprecision(3) << seconds
+			 << setw(14) << setprecision(0) << size / seconds << setw(10) << setprecision(2) << baseline / seconds
+			 << setw(10) << report.nodeCount << setw(8) << report.height << endl;
+	}
+
+	cout << (matched ? "every bulk build matched the insert loop" : "BULK BUILD MISMATCH") << endl;
+	return matched ? 0 : 1;
+}
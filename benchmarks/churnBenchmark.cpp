@@ -0,0 +1,86 @@
+#include "AVL.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Long-running insert / remove churn at a steady roster size, checking the tree stays within the AVL height bound
+	(At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/churnBenchmark benchmarks/churnBenchmark.cpp && build/churnBenchmark [size] [rounds]
+
+	The tree is filled to "size" students, then every round removes a random ufid (half of them absent) and inserts a
+	random one, so the roster size drifts around "size" while most of it is replaced many times over. After every
+	tenth of the run it reports throughput, remove hit rate, and height against log2(n) and the AVL bound
+	1.44 log2(n + 2) - 0.328.
+*/
+
+// streambuf that drops everything written to it
+class NullBuffer : public streambuf
+{
+	protected:
+		int overflow(int c) override { return c; }
+		streamsize xsputn(const char*, streamsize count) override { return count; }
+};
+
+
+string ufidOf(unsigned value)
+{
+	char ufid[16];
+	snprintf(ufid, sizeof(ufid), "%08u", value);
+	return ufid;
+}
+
+
+int main(int argc, char* argv[])
+{
+	int size = argc > 1 ? atoi(argv[1]) : 100000;
+	long long rounds = argc > 2 ? atoll(argv[2]) : 2000000;
+
+	// keys come from twice the roster size, so a random remove finds its ufid about half the time
+	unsigned keySpace = 2 * (unsigned)size;
+	mt19937 rng(41);
+	NullBuffer sink;
+	streambuf* original = cout.rdbuf(&sink);
+
+	AVLTree T;
+	for (int i = 0; i < size; i++)
+		T.insert("Student", ufidOf(10000000 + rng() % keySpace));
+
+	cout.rdbuf(original);
+	cout << left << setw(12) << "rounds" << right << setw(10) << "nodes" << setw(14) << "rounds/s" << setw(12) << "hit rate"
+		 << setw(8) << "height" << setw(8) << "log2 n" << setw(8) << "bound" << setw(12) << "unbalanced" << endl;
+	cout.rdbuf(&sink);
+
+	long long step = max(1LL, rounds / 10);
+	bool withinBound = true;
+	for (long long done = 0; done < rounds; done += step)
+	{
+		TreeStats::Snapshot before = T.stats();
+		auto start = chrono::steady_clock::now();
+		for (long long i = 0; i < step; i++)
+		{
+			T.remove(ufidOf(10000000 + rng() % keySpace));
+			T.insert("Student", ufidOf(10000000 + rng() % keySpace));
+		}
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		TreeStats::Snapshot after = T.stats();
+
+		AVLTree::Analysis report = T.analyze();
+		double bound = 1.44 * log2(report.nodeCount + 2) - 0.328;
+		withinBound = withinBound && report.height <= bound && report.unbalancedNodes == 0;
+
+		cout.rdbuf(original);
+		cout << left << setw(12) << done + step << right << setw(10) << report.nodeCount << fixed << setprecision(0)
+			 << setw(14) << step / seconds << setprecision(3) << setw(12) << (double)(after.removes - before.removes) / step
+			 << setw(8) << report.height << setprecision(1) << setw(8) << log2(max<size_t>(report.nodeCount, 1))
+			 << setw(8) << bound << setw(12) << report.unbalancedNodes << endl;
+		cout.rdbuf(&sink);
+	}
+
+	cout.rdbuf(original);
+	cout << (withinBound ? "height stayed within the AVL bound" : "HEIGHT LEFT THE AVL BOUND") << endl;
+	return withinBound ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#include "AVL.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Full inorder export of a large roster: printInorder on one thread against exportInorder on 1 .. N threads
+	(At the repository root):
+		g++ -std=c++14 -O2 -pthread -I. -o build/exportBenchmark benchmarks/exportBenchmark.cpp && build/exportBenchmark [size] [maxThreads]
+
+	Every export goes to a stream that counts and drops its bytes, so the table shows rendering cost rather than disk
+	speed; the byte counts must all match printInorder's.
+*/
+
+// streambuf that drops everything written to it, counting the bytes
+class CountingBuffer : public streambuf
+{
+	public:
+		size_t bytes = 0;
+
+	protected:
+		int overflow(int c) override { bytes++; return c; }
+		streamsize xsputn(const char*, streamsize count) override { bytes += count; return count; }
+};
+
+
+int main(int argc, char* argv[])
+{
+	int size = argc > 1 ? atoi(argv[1]) : 2000000;
+	unsigned maxThreads = argc > 2 ? (unsigned)atoi(argv[2]) : max(1u, thread::hardware_concurrency());
+
+	// random ufids and names of realistic length
+	mt19937 rng(44);
+	CountingBuffer sink;
+	streambuf* original = cout.rdbuf(&sink);
+	AVLTree T;
+	for (int i = 0; i < size; i++)
+	{
+		char ufid[16];
+		snprintf(ufid, sizeof(ufid), "%08u", 10000000 + (unsigned)(rng() % 90000000));
+		T.insert("Student Number " + to_string(i), ufid);
+	}
+
+	sink.bytes = 0;
+	auto start = chrono::steady_clock::now();
+	T.printInorder();
+	double baseline = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	size_t expectedBytes = sink.bytes;
+	cout.rdbuf(original);
+
+	cout << left << setw(22) << "export" << right << setw(12) << "seconds" << setw(12) << "MB/s" << setw(10) << "speedup"
+		 << setw(14) << "bytes" << endl;
+	cout << fixed << setprecision(3);
+	cout << left << setw(22) << "printInorder" << right << setw(12) << baseline << setw(12) << setprecision(1)
+		 << expectedBytes / baseline / 1e6 << setw(10) << 1.0 << setw(14) << expectedBytes << setprecision(3) << endl;
+
+	bool matched = true;
+	for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		CountingBuffer counter;
+		ostream out(&counter);
+		start = chrono::steady_clock::now();
+		T.exportInorder(out, threads);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		matched = matched && counter.bytes == expectedBytes;
+		cout << left << setw(22) << "exportInorder x" + to_string(threads) << right << setw(12) << seconds
+			 << setw(12) << setprecision(1) << counter.bytes / seconds / 1e6 << setw(10) << baseline / seconds
+			 << setw(14) << counter.bytes << setprecision(3) << endl;
+	}
+
+	cout << (matched ? "every export matched printInorder's size" : "EXPORT SIZE MISMATCH") << endl;
+	return matched ? 0 : 1;
+}
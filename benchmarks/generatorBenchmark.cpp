@@ -0,0 +1,159 @@
+#include "AVL.h"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <type_traits>
+using namespace std;
+
+/*
+	Cost of a coroutine generator traversal against the visitor walk, a hand-written stack iterator and the inorderVec
+	vector, for full walks and for taking just the first few students (needs C++20; at the repository root):
+		g++ -std=c++20 -O2 -pthread -I. -o build/generatorBenchmark benchmarks/generatorBenchmark.cpp && build/generatorBenchmark [size] [repeats]
+
+	Every walk sums the keys and name lengths it sees, so none of them can be optimized away and all must agree.
+*/
+
+// streambuf that drops everything written to it
+class NullBuffer : public streambuf
+{
+	protected:
+		int overflow(int c) override { return c; }
+		streamsize xsputn(const char*, streamsize count) override { return count; }
+};
+
+
+// hand-written inorder iterator over the tree's own nodes with an explicit stack: what a generator replaces
+class InorderIterator
+{
+	private:
+		using Node = remove_pointer_t<decltype(AVLTree::root)>;
+		vector<Node*> stack;
+
+		void pushLeft(Node* node)
+		{
+			for (; node != nullptr; node = node->left)
+				stack.push_back(node);
+		}
+
+	public:
+		explicit InorderIterator(Node* root) { pushLeft(root); }
+		bool done() const { return stack.empty(); }
+		Node* operator*() const { return stack.back(); }
+		void operator++()
+		{
+			Node* node = stack.back();
+			stack.pop_back();
+			pushLeft(node->right);
+		}
+};
+
+
+// times "walk" over "repeats" runs; returns nanoseconds per student and adds the walk's checksum to "checksum"
+double timeWalk(int repeats, size_t students, uint64_t& checksum, const function<uint64_t()>& walk)
+{
+	auto start = chrono::steady_clock::now();
+	for (int r = 0; r < repeats; r++)
+		checksum += walk();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return seconds * 1e9 / ((double)repeats * students);
+}
+
+
+int main(int argc, char* argv[])
+{
+	int size = argc > 1 ? atoi(argv[1]) : 1000000;
+	int repeats = argc > 2 ? atoi(argv[2]) : 10;
+	const size_t firstK = 10;
+
+	mt19937 rng(46);
+	NullBuffer sink;
+	streambuf* original = cout.rdbuf(&sink);
+	AVLTree T;
+	for (int i = 0; i < size; i++)
+	{
+		char ufid[16];
+		snprintf(ufid, sizeof(ufid), "%08u", 10000000 + (unsigned)(rng() % 90000000));
+		T.insert("Student" + to_string(i), ufid);
+	}
+	cout.rdbuf(original);
+	size_t students = T.analyze().nodeCount;
+
+	auto visitorWalk = [&](bool postorder, size_t limit)
+	{
+		uint64_t sum = 0;
+		size_t seen = 0;
+		auto visit = [&](const AVLTree::NodeView& student) { sum += student.key + student.name.size(); return ++seen < limit; };
+		postorder ? T.forEachPostorder(visit) : T.forEachInorder(visit);
+		return sum;
+	};
+	auto generatorWalk = [&](bool postorder, size_t limit)
+	{
+		uint64_t sum = 0;
+		size_t seen = 0;
+		for (const AVLTree::NodeView& student : postorder ? T.generatePostorder() : T.generateInorder())
+		{
+			sum += student.key + student.name.size();
+			if (++seen == limit)
+				break;
+		}
+		return sum;
+	};
+	auto iteratorWalk = [&](size_t limit)
+	{
+		uint64_t sum = 0;
+		size_t seen = 0;
+		for (InorderIterator it(T.root); !it.done() && seen < limit; ++it, ++seen)
+			sum += (*it)->key + (*it)->name.size();
+		return sum;
+	};
+	auto vectorWalk = [&](size_t limit)
+	{
+		uint64_t sum = 0;
+		T.inorderVec.clear();
+		T.inorder(T.root);
+		for (size_t i = 0; i < T.inorderVec.size() && i < limit; i++)
+			sum += T.inorderVec[i]->key + T.inorderVec[i]->name.size();
+		return sum;
+	};
+
+	cout << left << setw(24) << "walk" << right << setw(14) << "ns/student" << setw(12) << "vs visitor" << setw(22) << "checksum" << endl;
+	cout << fixed << setprecision(2);
+
+	// times one walk, prints it against the row of its visitor walk, and checks it saw what that visitor saw
+	bool agreed = true;
+	double reference = 0;
+	uint64_t expected = 0;
+	auto row = [&](const string& label, int runs, size_t perRun, const function<uint64_t()>& walk)
+	{
+		uint64_t checksum = 0;
+		double nanos = timeWalk(runs, perRun, checksum, walk);
+		checksum /= runs;
+		if (label.compare(0, 7, "visitor") == 0)
+		{
+			reference = nanos;
+			expected = checksum;
+		}
+		agreed = agreed && checksum == expected;
+		cout << left << setw(24) << label << right << setw(14) << nanos << setw(12) << nanos / reference << setw(22) << checksum << endl;
+	};
+
+	size_t all = SIZE_MAX;
+	row("visitor inorder", repeats, students, [&] { return visitorWalk(false, all); });
+	row("generator inorder", repeats, students, [&] { return generatorWalk(false, all); });
+	row("iterator inorder", repeats, students, [&] { return iteratorWalk(all); });
+	row("inorderVec", repeats, students, [&] { return vectorWalk(all); });
+	row("visitor postorder", repeats, students, [&] { return visitorWalk(true, all); });
+	row("generator postorder", repeats, students, [&] { return generatorWalk(true, all); });
+
+	// the first few students only: the lazy walks stop at once, the vector still collects the whole tree
+	int firstRepeats = repeats * 10000;
+	row("visitor first 10", firstRepeats, firstK, [&] { return visitorWalk(false, firstK); });
+	row("generator first 10", firstRepeats, firstK, [&] { return generatorWalk(false, firstK); });
+	row("iterator first 10", firstRepeats, firstK, [&] { return iteratorWalk(firstK); });
+	row("inorderVec first 10", repeats, firstK, [&] { return vectorWalk(firstK); });
+
+	cout << (agreed ? "every walk saw the same students" : "WALKS DISAGREE") << endl;
+	return agreed ? 0 : 1;
+}
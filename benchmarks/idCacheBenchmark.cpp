@@ -0,0 +1,87 @@
+#include "AVL.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Measures searchId throughput with and without the hot ufid cache on Zipf-skewed traffic (At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/idCacheBenchmark benchmarks/idCacheBenchmark.cpp && build/idCacheBenchmark [students] [searches] [zipf s] [slots]
+*/
+
+// runs every search against "T" with cout silenced and returns searches per second
+double runSearches(AVLTree& T, const vector<string>& searches)
+{
+	stringstream sink;
+	streambuf* original = cout.rdbuf(sink.rdbuf());
+	auto start = chrono::steady_clock::now();
+	for (const string& ufid : searches)
+	{
+		T.searchId(ufid);
+		if (sink.tellp() > (1 << 20))
+		{
+			sink.str("");
+		}
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout.rdbuf(original);
+	return searches.size() / seconds;
+}
+
+
+int main(int argc, char* argv[])
+{
+	int count = argc > 1 ? atoi(argv[1]) : 20000;
+	int searchCount = argc > 2 ? atoi(argv[2]) : 1000000;
+	double skew = argc > 3 ? atof(argv[3]) : 1.0;
+	int slots = argc > 4 ? atoi(argv[4]) : 4096;
+	mt19937 rng(11);
+
+	vector<string> ufids;
+	for (int i = 0; i < count; i++)
+	{
+		ufids.push_back(to_string(10000000 + (int)(rng() % 90000000)));
+	}
+
+	// Zipf(s) over student ranks via the inverse of the cumulative weights
+	vector<double> cumulative(count);
+	double total = 0;
+	for (int i = 0; i < count; i++)
+	{
+		total += 1.0 / pow(i + 1, skew);
+		cumulative[i] = total;
+	}
+	vector<string> searches;
+	uniform_real_distribution<double> uniform(0, total);
+	for (int i = 0; i < searchCount; i++)
+	{
+		int rank = (int)(lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) - cumulative.begin());
+		searches.push_back(ufids[min(rank, count - 1)]);
+	}
+
+	AVLTree plain;
+	AVLTree cached;
+	cached.enableIdCache(slots);
+	stringstream sink;
+	streambuf* original = cout.rdbuf(sink.rdbuf());
+	for (const string& ufid : ufids)
+	{
+		plain.insert("Student", ufid);
+		cached.insert("Student", ufid);
+	}
+	cout.rdbuf(original);
+
+	double plainRate = runSearches(plain, searches);
+	double cachedRate = runSearches(cached, searches);
+
+	cout << fixed << setprecision(0);
+	cout << "students:            " << count << " (zipf s = " << skew << ", " << slots << " slots)" << endl;
+	cout << "searchId, no cache:  " << plainRate << " ops/s" << endl;
+	cout << "searchId, cache:     " << cachedRate << " ops/s" << endl;
+	cout << setprecision(4);
+	cout << "cache hit rate:      " << cached.idCacheStats().hitRate() << endl;
+	return 0;
+}
@@ -0,0 +1,79 @@
+#include "AVL.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Measures searchId throughput with and without the ufid Bloom filter on traffic where most ufids are absent (At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/idFilterBenchmark benchmarks/idFilterBenchmark.cpp && build/idFilterBenchmark [students] [searches] [absent%]
+*/
+
+// runs every search against "T" with cout silenced and returns searches per second
+double runSearches(AVLTree& T, const vector<string>& searches)
+{
+	stringstream sink;
+	streambuf* original = cout.rdbuf(sink.rdbuf());
+	auto start = chrono::steady_clock::now();
+	for (const string& ufid : searches)
+	{
+		T.searchId(ufid);
+		if (sink.tellp() > (1 << 20))
+		{
+			sink.str("");
+		}
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout.rdbuf(original);
+	return searches.size() / seconds;
+}
+
+
+int main(int argc, char* argv[])
+{
+	int count = argc > 1 ? atoi(argv[1]) : 20000;
+	int searchCount = argc > 2 ? atoi(argv[2]) : 1000000;
+	int absentPercent = argc > 3 ? atoi(argv[3]) : 60;
+	mt19937 rng(7);
+
+	// present ufids are even, absent ufids are odd, so the two sets never overlap
+	vector<string> present;
+	for (int i = 0; i < count; i++)
+	{
+		present.push_back(to_string(10000000 + 2 * (int)(rng() % 40000000)));
+	}
+	vector<string> searches;
+	for (int i = 0; i < searchCount; i++)
+	{
+		if ((int)(rng() % 100) < absentPercent)
+			searches.push_back(to_string(10000001 + 2 * (int)(rng() % 40000000)));
+		else
+			searches.push_back(present[rng() % count]);
+	}
+
+	AVLTree plain;
+	AVLTree filtered;
+	filtered.enableIdFilter(count);
+	stringstream sink;
+	streambuf* original = cout.rdbuf(sink.rdbuf());
+	for (const string& ufid : present)
+	{
+		plain.insert("Student", ufid);
+		filtered.insert("Student", ufid);
+	}
+	cout.rdbuf(original);
+
+	double plainRate = runSearches(plain, searches);
+	double filteredRate = runSearches(filtered, searches);
+	IdFilter::Stats stats = filtered.idFilterStats();
+
+	cout << fixed << setprecision(0);
+	cout << "students:             " << count << " (" << absentPercent << "% of searches absent)" << endl;
+	cout << "searchId, no filter:  " << plainRate << " ops/s" << endl;
+	cout << "searchId, filter:     " << filteredRate << " ops/s" << endl;
+	cout << setprecision(4);
+	cout << "filter hit rate:      " << stats.hitRate() << endl;
+	cout << "false positive rate:  " << stats.falsePositiveRate() << endl;
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include "AVL.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Measures searchId throughput of the plain tree against hybrid hash mode, plus the cost of an ordered range scan (At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/idHashBenchmark benchmarks/idHashBenchmark.cpp && build/idHashBenchmark [students] [searches]
+*/
+
+// runs "operation" with cout silenced and returns the elapsed seconds
+template <typename Operation>
+double timeSilenced(Operation operation)
+{
+	stringstream sink;
+	streambuf* original = cout.rdbuf(sink.rdbuf());
+	auto start = chrono::steady_clock::now();
+	operation();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout.rdbuf(original);
+	return seconds;
+}
+
+
+int main(int argc, char* argv[])
+{
+	int count = argc > 1 ? atoi(argv[1]) : 20000;
+	int searchCount = argc > 2 ? atoi(argv[2]) : 1000000;
+	mt19937 rng(3);
+
+	vector<string> ufids;
+	for (int i = 0; i < count; i++)
+	{
+		ufids.push_back(to_string(10000000 + (int)(rng() % 90000000)));
+	}
+	vector<string> searches;
+	for (int i = 0; i < searchCount; i++)
+	{
+		searches.push_back(rng() % 2 ? ufids[rng() % count] : to_string(10000000 + (int)(rng() % 90000000)));
+	}
+
+	AVLTree plain;
+	AVLTree hybrid;
+	hybrid.enableIdHash();
+	timeSilenced([&]()
+	{
+		for (const string& ufid : ufids)
+		{
+			plain.insert("Student", ufid);
+			hybrid.insert("Student", ufid);
+		}
+	});
+
+	double plainSeconds = timeSilenced([&]() { for (const string& ufid : searches) plain.searchId(ufid); });
+	double hybridSeconds = timeSilenced([&]() { for (const string& ufid : searches) hybrid.searchId(ufid); });
+	double rangeSeconds = timeSilenced([&]() { for (int i = 0; i < 1000; i++) hybrid.searchRange("50000000", "50100000"); });
+
+	cout << fixed << setprecision(0);
+	cout << "students:              " << count << " (50% of searches absent)" << endl;
+	cout << "searchId, tree:        " << searchCount / plainSeconds << " ops/s" << endl;
+	cout << "searchId, hybrid hash: " << searchCount / hybridSeconds << " ops/s" << endl;
+	cout << setprecision(2);
+	cout << "searchRange (0.1%):    " << rangeSeconds * 1000 << " us" << endl;
+	return 0;
+}
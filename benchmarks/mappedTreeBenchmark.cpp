@@ -0,0 +1,100 @@
+#include "AVL.h"
+#include "MappedAVLTree.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Compares a cold start of the memory-mapped tree (map the file, then search) with loading a binary snapshot into an
+	in-memory AVLTree, and the searchId cost of both once running (At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/mappedTreeBenchmark benchmarks/mappedTreeBenchmark.cpp && build/mappedTreeBenchmark [students] [searches]
+*/
+
+double secondsSince(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+int main(int argc, char* argv[])
+{
+	int count = argc > 1 ? atoi(argv[1]) : 1000000;
+	int searchCount = argc > 2 ? atoi(argv[2]) : 1000000;
+	mt19937 rng(29);
+	vector<string> ufids;
+	for (int i = 0; i < count; i++)
+	{
+		char ufid[16];
+		snprintf(ufid, sizeof(ufid), "%08u", (unsigned)(rng() % 100000000));
+		ufids.push_back(ufid);
+	}
+
+	// build both representations once
+	std::remove("mappedTreeBenchmark.avl");
+	std::remove("mappedTreeBenchmark.avl.names");
+	{
+		MappedAVLTree M;
+		M.open("mappedTreeBenchmark.avl");
+		AVLTree T;
+		stringstream sink;
+		streambuf* original = cout.rdbuf(sink.rdbuf());
+		for (const string& ufid : ufids)
+		{
+			M.insertStudent("Student Name", ufid);
+			T.insert("Student Name", ufid);
+			sink.str("");
+		}
+		cout.rdbuf(original);
+		T.saveSnapshot("mappedTreeBenchmark.bin");
+	}
+
+	vector<string> searches;
+	for (int i = 0; i < searchCount; i++)
+		searches.push_back(ufids[rng() % count]);
+
+	// cold start: time until the first answer, then steady state searches
+	auto start = chrono::steady_clock::now();
+	MappedAVLTree M;
+	M.open("mappedTreeBenchmark.avl");
+	string name;
+	M.findStudent(searches[0], name);
+	double mappedStart = secondsSince(start);
+	start = chrono::steady_clock::now();
+	size_t found = 0;
+	for (const string& ufid : searches)
+		found += M.findStudent(ufid, name);
+	double mappedSearch = secondsSince(start);
+
+	start = chrono::steady_clock::now();
+	AVLTree T;
+	T.loadSnapshot("mappedTreeBenchmark.bin");
+	double snapshotStart = secondsSince(start);
+	stringstream sink;
+	streambuf* original = cout.rdbuf(sink.rdbuf());
+	start = chrono::steady_clock::now();
+	for (const string& ufid : searches)
+	{
+		T.searchId(ufid);
+		sink.str("");
+	}
+	double memorySearch = secondsSince(start);
+	cout.rdbuf(original);
+
+	cout << fixed << setprecision(4);
+	cout << "students:                    " << count << " (mapped height " << M.height() << ")" << endl;
+	cout << "mapped open + first search:  " << mappedStart << " s" << endl;
+	cout << "snapshot load:               " << snapshotStart << " s" << endl;
+	cout << setprecision(0);
+	cout << "mapped searchId:             " << searchCount / mappedSearch << " ops/s" << endl;
+	cout << "in-memory searchId:          " << searchCount / memorySearch << " ops/s" << endl;
+	cout << "(found " << found << ")" << endl;
+
+	M.close();
+	std::remove("mappedTreeBenchmark.avl");
+	std::remove("mappedTreeBenchmark.avl.names");
+	std::remove("mappedTreeBenchmark.bin");
+	return 0;
+}
@@ -0,0 +1,100 @@
+#include "NameIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+using namespace std;
+
+/*
+	Measures prefix / case-insensitive lookups in the NameIndex against the full scan done by searchName (At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/nameIndexBenchmark benchmarks/nameIndexBenchmark.cpp && build/nameIndexBenchmark [names] [queries]
+*/
+
+// builds a pseudo-random "First Last" name out of syllables so prefixes are shared the way real rosters share them
+string randomName(mt19937& rng)
+{
+	static const char* syllables[] = {"jo", "ha", "an", "na", "mi", "ke", "li", "sa", "ro", "be", "th", "el", "da", "vi", "ra", "ch"};
+	string name;
+	for (int word = 0; word < 2; word++)
+	{
+		int length = 2 + rng() % 3;
+		for (int i = 0; i < length; i++)
+		{
+			name += syllables[rng() % 16];
+		}
+		name[name.size() - 2 * length] = (char)toupper(name[name.size() - 2 * length]);
+		if (word == 0)
+		{
+			name += " ";
+		}
+	}
+	return name;
+}
+
+
+int main(int argc, char* argv[])
+{
+	int count = argc > 1 ? atoi(argv[1]) : 5000000;
+	int queries = argc > 2 ? atoi(argv[2]) : 10000;
+	mt19937 rng(42);
+
+	// generate the roster; ufids are unique 8-digit strings
+	vector<pair<string, string>> roster;
+	roster.reserve(count);
+	for (int i = 0; i < count; i++)
+	{
+		char ufid[16];
+		snprintf(ufid, sizeof(ufid), "%08d", i);
+		roster.push_back(make_pair(randomName(rng), string(ufid)));
+	}
+
+	auto start = chrono::steady_clock::now();
+	NameIndex index;
+	for (auto& entry : roster)
+	{
+		index.insert(entry.first, entry.second);
+	}
+	double buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	// query prefixes of 3 letters taken from existing names, with a front-desk sized limit of 20 results
+	vector<string> prefixes;
+	for (int i = 0; i < queries; i++)
+	{
+		prefixes.push_back(roster[rng() % count].first.substr(0, 3));
+	}
+
+	size_t found = 0;
+	vector<double> latencies;
+	for (auto& prefix : prefixes)
+	{
+		auto queryStart = chrono::steady_clock::now();
+		found += index.matchPrefix(prefix, 20).size();
+		latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - queryStart).count());
+	}
+	sort(latencies.begin(), latencies.end());
+
+	// full scan baseline: what searchName costs per query (compare every stored name)
+	int scanQueries = min(queries, 20);
+	start = chrono::steady_clock::now();
+	for (int i = 0; i < scanQueries; i++)
+	{
+		string folded = NameIndex::fold(prefixes[i]);
+		for (auto& entry : roster)
+		{
+			found += NameIndex::fold(entry.first.substr(0, folded.size())) == folded;
+		}
+	}
+	double scanMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / scanQueries;
+
+	cout << fixed << setprecision(2);
+	cout << "names:              " << count << endl;
+	cout << "index build:        " << buildSeconds << " s" << endl;
+	cout << "prefix p50:         " << latencies[latencies.size() / 2] << " us" << endl;
+	cout << "prefix p99:         " << latencies[latencies.size() * 99 / 100] << " us" << endl;
+	cout << "prefix max:         " << latencies.back() << " us" << endl;
+	cout << "full scan / query:  " << scanMicros << " us" << endl;
+	cout << "(matches: " << found << ")" << endl;
+	return 0;
+}
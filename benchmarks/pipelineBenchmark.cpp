@@ -0,0 +1,94 @@
+#include "AVL.h"
+#include "CommandPipeline.h"
+#include "Commands.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sstream>
+using namespace std;
+
+/*
+	Commands per second of the plain driver loop (getline, executeCommand, print) against the three-stage pipelined driver
+	at several batch sizes, on one large generated command file (at the repository root):
+		g++ -std=c++14 -O2 -pthread -I. -o build/pipelineBenchmark benchmarks/pipelineBenchmark.cpp && build/pipelineBenchmark [commands] [outputPath]
+
+	The mix is 40% insert, 40% search by ufid, 15% remove and 5% invalid lines over a key space a tenth of the command
+	count. Output goes to "outputPath" (default /dev/null) through an ofstream, the way main.cpp's cout reaches a file or
+	pipe; both drivers must produce the same bytes, which is checked once in memory first.
+*/
+
+int main(int argc, char* argv[])
+{
+	long long count = argc > 1 ? atoll(argv[1]) : 1000000;
+	string outputPath = argc > 2 ? argv[2] : "/dev/null";
+
+	mt19937 rng(47);
+	unsigned keySpace = (unsigned)max(1LL, count / 10);
+	string input;
+	for (long long i = 0; i < count; i++)
+	{
+		string ufid = to_string(10000000 + rng() % keySpace);
+		unsigned pick = rng() % 100;
+		if (pick < 40)
+			input += "insert \"Student Number\" " + ufid + "\n";
+		else if (pick < 80)
+			input += "search " + ufid + "\n";
+		else if (pick < 95)
+			input += "remove " + ufid + "\n";
+		else
+			input += "insert \"Student 7\" " + ufid + "\n";
+	}
+
+	auto runSequential = [&](ostream& out)
+	{
+		AVLTree T;
+		istringstream in(input);
+		streambuf* original = cout.rdbuf(out.rdbuf());
+		string line;
+		for (long long i = 0; i < count; i++)
+		{
+			getline(in, line);
+			executeCommand(T, line);
+		}
+		cout.rdbuf(original);
+	};
+	auto runPipeline = [&](ostream& out, size_t batch)
+	{
+		AVLTree T;
+		istringstream in(input);
+		runPipelined(T, in, count, out, batch);
+	};
+
+	// correctness once, in memory
+	ostringstream expected;
+	ostringstream pipelined;
+	runSequential(expected);
+	runPipeline(pipelined, 256);
+	bool matched = expected.str() == pipelined.str();
+
+	cout << left << setw(20) << "driver" << right << setw(12) << "seconds" << setw(16) << "commands/s" << setw(10) << "speedup" << endl;
+	cout << fixed;
+	double baseline = 0;
+	auto row = [&](const string& label, const function<void(ostream&)>& run)
+	{
+		ofstream out(outputPath, ios::binary | ios::trunc);
+		auto start = chrono::steady_clock::now();
+		run(out);
+		out.flush();
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		if (baseline == 0)
+			baseline = seconds;
+		cout << left << setw(20) << label << right << setw(12) << setprecision(3) << seconds << setw(16) << setprecision(0)
+			 << count / seconds << setw(10) << setprecision(2) << baseline / seconds << endl;
+	};
+
+	row("sequential", runSequential);
+	for (size_t batch : {1, 16, 256, 4096})
+		row("pipeline x" + to_string(batch), [&](ostream& out) { runPipeline(out, batch); });
+
+	cout << (matched ? "pipelined output matched the sequential driver" : "PIPELINED OUTPUT DIFFERS") << endl;
+	return matched ? 0 : 1;
+}
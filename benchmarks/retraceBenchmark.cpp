@@ -0,0 +1,189 @@
+#include "AVL.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Counts the memory stores made by the old recursive insert (which reassigns every child link and balance factor on the way
+	back up) against the bottom-up retrace AVLTree now uses (which stops once heights stop changing), then times AVLTree itself
+	(At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/retraceBenchmark benchmarks/retraceBenchmark.cpp && build/retraceBenchmark [students]
+*/
+
+// minimal node used to replay both write patterns on identical key sequences
+struct ModelNode
+{
+	int key;
+	int height = 1;
+	ModelNode* left = nullptr;
+	ModelNode* right = nullptr;
+	ModelNode* parent = nullptr;
+};
+
+long long stores = 0;
+
+int heightOf(ModelNode* node) { return node == nullptr ? 0 : node->height; }
+
+void update(ModelNode* node)
+{
+	node->height = max(heightOf(node->left), heightOf(node->right)) + 1;
+	stores++;
+}
+
+ModelNode* rotate(ModelNode* node, bool leftRotation)
+{
+	ModelNode* newParent = leftRotation ? node->right : node->left;
+	ModelNode* grandChild = leftRotation ? newParent->left : newParent->right;
+	if (leftRotation)
+	{
+		newParent->left = node;
+		node->right = grandChild;
+	}
+	else
+	{
+		newParent->right = node;
+		node->left = grandChild;
+	}
+	if (grandChild != nullptr)
+		grandChild->parent = node;
+	newParent->parent = node->parent;
+	node->parent = newParent;
+	stores += 5;
+	update(node);
+	update(newParent);
+	return newParent;
+}
+
+ModelNode* balance(ModelNode* node)
+{
+	int factor = heightOf(node->left) - heightOf(node->right);
+	if (factor > 1)
+	{
+		if (heightOf(node->left->left) < heightOf(node->left->right))
+		{
+			node->left = rotate(node->left, true);
+			stores++;
+		}
+		return rotate(node, false);
+	}
+	if (factor < -1)
+	{
+		if (heightOf(node->right->right) < heightOf(node->right->left))
+		{
+			node->right = rotate(node->right, false);
+			stores++;
+		}
+		return rotate(node, true);
+	}
+	return node;
+}
+
+// old pattern: every level stores its child link and its balance information, rotated or not
+ModelNode* recursiveInsert(ModelNode* node, int key)
+{
+	if (node == nullptr)
+	{
+		ModelNode* leaf = new ModelNode();
+		leaf->key = key;
+		return leaf;
+	}
+	if (key < node->key)
+		node->left = recursiveInsert(node->left, key);
+	else if (key > node->key)
+		node->right = recursiveInsert(node->right, key);
+	else
+		return node;
+	stores++;
+	update(node);
+	return balance(node);
+}
+
+// new pattern: descend without writing, link the leaf, retrace upward until a height comes out unchanged
+void iterativeInsert(ModelNode*& root, int key)
+{
+	ModelNode* parent = nullptr;
+	ModelNode* node = root;
+	while (node != nullptr)
+	{
+		if (key == node->key)
+			return;
+		parent = node;
+		node = key < node->key ? node->left : node->right;
+	}
+	ModelNode* leaf = new ModelNode();
+	leaf->key = key;
+	leaf->parent = parent;
+	ModelNode*& slot = parent == nullptr ? root : (key < parent->key ? parent->left : parent->right);
+	slot = leaf;
+	stores++;
+
+	for (node = parent; node != nullptr; )
+	{
+		int oldHeight = node->height;
+		int newHeight = max(heightOf(node->left), heightOf(node->right)) + 1;
+		if (newHeight == oldHeight && abs(heightOf(node->left) - heightOf(node->right)) <= 1)
+			return;
+		node->height = newHeight;
+		stores++;
+		ModelNode* up = node->parent;
+		ModelNode* subtree = balance(node);
+		if (subtree != node)
+		{
+			ModelNode*& link = up == nullptr ? root : (up->left == node ? up->left : up->right);
+			link = subtree;
+			stores++;
+			return;
+		}
+		node = up;
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	int count = argc > 1 ? atoi(argv[1]) : 200000;
+	mt19937 rng(5);
+	vector<int> keys;
+	for (int i = 0; i < count; i++)
+	{
+		keys.push_back(10000000 + (int)(rng() % 90000000));
+	}
+
+	ModelNode* recursiveRoot = nullptr;
+	stores = 0;
+	for (int key : keys)
+		recursiveRoot = recursiveInsert(recursiveRoot, key);
+	long long recursiveStores = stores;
+
+	ModelNode* iterativeRoot = nullptr;
+	stores = 0;
+	for (int key : keys)
+		iterativeInsert(iterativeRoot, key);
+	long long iterativeStores = stores;
+
+	// real tree: random inserts, then removing every other key
+	AVLTree T;
+	stringstream sink;
+	streambuf* original = cout.rdbuf(sink.rdbuf());
+	auto start = chrono::steady_clock::now();
+	for (int key : keys)
+		T.insert("Student", to_string(key));
+	double insertSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	start = chrono::steady_clock::now();
+	for (int i = 0; i < count; i += 2)
+		T.remove(to_string(keys[i]));
+	double removeSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout.rdbuf(original);
+
+	cout << fixed << setprecision(2);
+	cout << "inserts:                   " << count << endl;
+	cout << "stores / insert, recursive: " << (double)recursiveStores / count << endl;
+	cout << "stores / insert, retrace:   " << (double)iterativeStores / count << endl;
+	cout << setprecision(0);
+	cout << "AVLTree insert:             " << count / insertSeconds << " ops/s" << endl;
+	cout << "AVLTree remove:             " << (count / 2) / removeSeconds << " ops/s" << endl;
+	return 0;
+}
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+
+/*
+	Load generator for server mode: several clients send a mixed command stream over the Unix socket, each keeping up to
+	"window" commands in flight, and the run reports throughput and reply latency percentiles (at the repository root):
+		g++ -std=c++14 -O2 -pthread -I. -o build/main main.cpp && build/main --serve /tmp/roster.sock &
+		g++ -std=c++14 -O2 -pthread -o build/serverLoadClient benchmarks/serverLoadClient.cpp
+		build/serverLoadClient /tmp/roster.sock [clients] [commandsPerClient] [window]
+
+	Each client works on its own slice of ufids with 40% inserts, 50% searches by ufid and 10% removes, so replies are
+	deterministic per client; every reply must be one of the strings the command can print. A window of 1 measures
+	plain request / response latency; larger windows show what the server's batching buys.
+*/
+
+struct ClientResult
+{
+	vector<double> latencies;   // microseconds from send to complete reply
+	size_t badReplies = 0;
+	bool connected = false;
+};
+
+
+int connectTo(const string& path)
+{
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+	if (fd >= 0 && connect(fd, (sockaddr*)&address, sizeof(address)) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+
+void runClient(const string& path, int id, int commands, int window, ClientResult& result)
+{
+	int fd = connectTo(path);
+	if (fd < 0)
+		return;
+	result.connected = true;
+	result.latencies.reserve(commands);
+
+	mt19937 rng(48 + id);
+	unsigned base = 10000000 + (unsigned)id * 1000000;
+	deque<chrono::steady_clock::time_point> inFlight;
+	string reply;
+	char buffer[65536];
+	int sent = 0;
+	int received = 0;
+	while (received < commands)
+	{
+		// top the window up in one write
+		string request;
+		while (sent < commands && (int)inFlight.size() < window)
+		{
+			string ufid = to_string(base + rng() % 50000);
+			unsigned pick = rng() % 10;
+			request += pick < 4 ? "insert \"Load Client\" " + ufid + "\n" : pick < 9 ? "search " + ufid + "\n" : "remove " + ufid + "\n";
+			inFlight.push_back(chrono::steady_clock::now());
+			sent++;
+		}
+		for (size_t done = 0; done < request.size();)
+		{
+			ssize_t written = write(fd, request.data() + done, request.size() - done);
+			if (written <= 0)
+			{
+				close(fd);
+				return;
+			}
+			done += (size_t)written;
+		}
+
+		// read until at least one reply completes; every '\0' closes one
+		ssize_t count = read(fd, buffer, sizeof(buffer));
+		if (count <= 0)
+			break;
+		auto now = chrono::steady_clock::now();
+		for (ssize_t i = 0; i < count; i++)
+		{
+			if (buffer[i] != '\0')
+			{
+				reply += buffer[i];
+				continue;
+			}
+			result.latencies.push_back(chrono::duration<double, micro>(now - inFlight.front()).count());
+			inFlight.pop_front();
+			received++;
+			bool known = reply == "successful\n" || reply == "unsuccessful\n" || reply == "Load Client\n";
+			result.badReplies += !known;
+			reply.clear();
+		}
+	}
+	close(fd);
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		cerr << "usage: serverLoadClient SOCKETPATH [clients] [commandsPerClient] [window]" << endl;
+		return 1;
+	}
+	string path = argv[1];
+	int clients = argc > 2 ? atoi(argv[2]) : 4;
+	int commands = argc > 3 ? atoi(argv[3]) : 100000;
+	int window = argc > 4 ? max(1, atoi(argv[4])) : 32;
+
+	vector<ClientResult> results(clients);
+	vector<thread> threads;
+	auto start = chrono::steady_clock::now();
+	for (int id = 0; id < clients; id++)
+		threads.push_back(thread(runClient, path, id, commands, window, ref(results[id])));
+	for (thread& t : threads)
+		t.join();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	vector<double> latencies;
+	size_t badReplies = 0;
+	for (const ClientResult& result : results)
+	{
+		if (!result.connected)
+		{
+			cerr << "could not connect to " << path << endl;
+			return 1;
+		}
+		latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+		badReplies += result.badReplies;
+	}
+	sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double p) { return latencies.empty() ? 0.0 : latencies[min(latencies.size() - 1, (size_t)(p * latencies.size()))]; };
+
+	cout << fixed << setprecision(0);
+	cout << clients << " clients x " << commands << " commands, window " << window << ": " << latencies.size() / seconds
+		 << " commands/s" << endl;
+	cout << setprecision(1) << "latency us  p50 " << percentile(0.5) << "  p90 " << percentile(0.9) << "  p99 "
+		 << percentile(0.99) << "  max " << (latencies.empty() ? 0.0 : latencies.back()) << endl;
+	cout << (badReplies == 0 ? "every reply was well formed" : to_string(badReplies) + " MALFORMED REPLIES") << endl;
+	return badReplies == 0 && latencies.size() == (size_t)clients * commands ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include "AVL.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Compares startup time of replaying insert commands (what a restart does today) against loading a binary snapshot
+	(At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/snapshotBenchmark benchmarks/snapshotBenchmark.cpp && build/snapshotBenchmark [students]
+*/
+
+int main(int argc, char* argv[])
+{
+	int count = argc > 1 ? atoi(argv[1]) : 1000000;
+	mt19937 rng(17);
+
+	// write the roster as main.cpp insert commands
+	{
+		ofstream commands("snapshotBenchmark.txt");
+		commands << count << "\n";
+		for (int i = 0; i < count; i++)
+		{
+			char line[64];
+			snprintf(line, sizeof(line), "insert \"Student %c%c\" %08u\n", (int)('A' + rng() % 26), (int)('a' + rng() % 26), (unsigned)(rng() % 100000000));
+			commands << line;
+		}
+	}
+
+	stringstream sink;
+	streambuf* original = cout.rdbuf(sink.rdbuf());
+
+	// text replay: read each line, split out the quoted name and the ufid, insert
+	auto start = chrono::steady_clock::now();
+	AVLTree replayed;
+	{
+		ifstream commands("snapshotBenchmark.txt");
+		string line;
+		getline(commands, line);
+		while (getline(commands, line))
+		{
+			size_t open = line.find('"');
+			size_t close = line.find('"', open + 1);
+			replayed.insert(line.substr(open + 1, close - open - 1), line.substr(close + 2));
+			sink.str("");
+		}
+	}
+	double replaySeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	start = chrono::steady_clock::now();
+	replayed.saveSnapshot("snapshotBenchmark.bin");
+	double saveSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	start = chrono::steady_clock::now();
+	AVLTree loaded;
+	bool ok = loaded.loadSnapshot("snapshotBenchmark.bin");
+	double loadSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout.rdbuf(original);
+
+	ifstream snapshot("snapshotBenchmark.bin", ios::binary | ios::ate);
+	cout << fixed << setprecision(3);
+	cout << "students:         " << count << endl;
+	cout << "text replay:      " << replaySeconds << " s" << endl;
+	cout << "snapshot save:    " << saveSeconds << " s (" << snapshot.tellg() / 1024 << " KiB)" << endl;
+	cout << "snapshot load:    " << loadSeconds << " s" << (ok ? "" : " (FAILED)") << endl;
+	cout << setprecision(1) << "speedup:          " << replaySeconds / loadSeconds << "x" << endl;
+	std::remove("snapshotBenchmark.txt");
+	std::remove("snapshotBenchmark.bin");
+	return 0;
+}
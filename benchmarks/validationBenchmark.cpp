@@ -0,0 +1,141 @@
+#include "AVL.h"
+#include "Commands.h"
+#include "InputValidation.h"
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Nanoseconds per name / ufid of the insert checks: the old isalpha / isspace / isdigit loops (and stoi) against the
+	scalar, SSE4.2 and AVX2 name checks and the SWAR ufid check and conversion (at the repository root):
+		g++ -std=c++14 -O2 -I. -o build/validationBenchmark benchmarks/validationBenchmark.cpp && build/validationBenchmark [count]
+
+	Short names are 3 .. 24 characters (the usual roster), long names 40 .. 160; one in fifty holds an invalid character
+	somewhere. Every row must count the same number of valid inputs as the loop it replaces. The SSE4.2 / AVX2 rows only
+	run where the CPU has those instructions; "validNameText" is whichever one the parser picks.
+*/
+
+int main(int argc, char* argv[])
+{
+	size_t count = argc > 1 ? (size_t)atoll(argv[1]) : 1000000;
+
+	mt19937 rng(50);
+	const string letters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ    ";
+	auto makeNames = [&](size_t shortest, size_t longest)
+	{
+		vector<string> names(count);
+		for (string& name : names)
+		{
+			name.resize(shortest + rng() % (longest - shortest + 1));
+			for (char& c : name)
+			{
+				c = letters[rng() % letters.size()];
+			}
+			if (rng() % 50 == 0)
+			{
+				name[rng() % name.size()] = ".-'7"[rng() % 4];
+			}
+		}
+		return names;
+	};
+	vector<string> shortNames = makeNames(3, 24);
+	vector<string> longNames = makeNames(40, 160);
+	vector<string> ufids(count);
+	for (string& ufid : ufids)
+	{
+		ufid = to_string(10000000 + rng() % 90000000);
+		if (rng() % 50 == 0)
+		{
+			ufid[rng() % 8] = 'x';
+		}
+	}
+
+	// runs "body" over every input, returning (ns per input, number of valid inputs or checksum)
+	auto time = [&](const vector<string>& inputs, const function<size_t(const string&)>& body)
+	{
+		auto start = chrono::steady_clock::now();
+		size_t total = 0;
+		for (const string& input : inputs)
+		{
+			total += body(input);
+		}
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		return make_pair(seconds * 1e9 / inputs.size(), total);
+	};
+
+	bool matched = true;
+	cout << left << setw(28) << "check" << right << setw(14) << "short ns" << setw(14) << "long ns" << setw(12) << "valid" << endl;
+	cout << fixed << setprecision(2);
+	size_t expectedShort = 0;
+	size_t expectedLong = 0;
+	auto nameRow = [&](const string& what, const function<size_t(const string&)>& body)
+	{
+		pair<double, size_t> shortRun = time(shortNames, body);
+		pair<double, size_t> longRun = time(longNames, body);
+		if (what == "isalpha / isspace loop")
+		{
+			expectedShort = shortRun.second;
+			expectedLong = longRun.second;
+		}
+		matched = matched && shortRun.second == expectedShort && longRun.second == expectedLong;
+		cout << left << setw(28) << what << right << setw(14) << shortRun.first << setw(14) << longRun.first << setw(12)
+			 << shortRun.second << endl;
+	};
+
+	nameRow("isalpha / isspace loop", [](const string& name)
+	{
+		for (char c : name)
+		{
+			if (!isalpha(c) && !isspace(c))
+				return (size_t)0;
+		}
+		return (size_t)1;
+	});
+	nameRow("scalar", [](const string& name) { return (size_t)validNameTextScalar(name.data(), name.size()); });
+#if INPUT_VALIDATION_X86
+	if (__builtin_cpu_supports("sse4.2"))
+		nameRow("SSE4.2", [](const string& name) { return (size_t)validNameTextSse42(name.data(), name.size()); });
+	if (__builtin_cpu_supports("avx2"))
+		nameRow("AVX2", [](const string& name) { return (size_t)validNameTextAvx2(name.data(), name.size()); });
+#endif
+	nameRow("validNameText", [](const string& name) { return (size_t)validNameText(name); });
+
+	cout << endl << left << setw(28) << "ufid check + key" << right << setw(14) << "ns" << setw(26) << "checksum" << endl;
+	size_t expectedChecksum = 0;
+	auto ufidRow = [&](const string& what, const function<size_t(const string&)>& body)
+	{
+		pair<double, size_t> run = time(ufids, body);
+		if (expectedChecksum == 0)
+			expectedChecksum = run.second;
+		matched = matched && run.second == expectedChecksum;
+		cout << left << setw(28) << what << right << setw(14) << run.first << setw(26) << run.second << endl;
+	};
+	ufidRow("isdigit loop + stoi", [](const string& ufid)
+	{
+		if (ufid.length() != 8)
+			return (size_t)0;
+		for (char c : ufid)
+		{
+			if (!isdigit(c))
+				return (size_t)0;
+		}
+		return (size_t)stoi(ufid);
+	});
+	ufidRow("SWAR", [](const string& ufid) { return validUfid(ufid) ? (size_t)parseEightDigits(ufid.data()) : (size_t)0; });
+
+	// the whole parse of an insert line, for scale: the checks are now a small part of it
+	vector<string> lines(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		lines[i] = "insert \"" + shortNames[i] + "\" " + ufids[i];
+	}
+	pair<double, size_t> parse = time(lines, [](const string& line) { return (size_t)(parseCommand(line).op == ParsedCommand::Insert); });
+	cout << endl << left << setw(28) << "parseCommand insert" << right << setw(14) << parse.first << setw(26) << parse.second << endl;
+
+	cout << (matched ? "every check agreed with the loop it replaces" : "CHECKS DISAGREE") << endl;
+	return matched ? 0 : 1;
+}
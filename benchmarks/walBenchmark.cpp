@@ -0,0 +1,51 @@
+#include "AVL.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+/*
+	Measures durable insert / remove throughput with the write-ahead log at several group commit windows (At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/walBenchmark benchmarks/walBenchmark.cpp && build/walBenchmark [commands]
+	Run it on the filesystem the roster will live on; fsync cost is what the windows trade against.
+*/
+
+int main(int argc, char* argv[])
+{
+	int count = argc > 1 ? atoi(argv[1]) : 20000;
+	int windows[] = {0, 100, 1000, 10000};
+
+	cout << fixed << setprecision(0);
+	cout << "commands: " << count << " (2/3 insert, 1/3 remove)" << endl;
+	for (int window : windows)
+	{
+		std::remove("walBenchmark.log");
+		std::remove("walBenchmark.snap");
+		mt19937 rng(23);
+
+		AVLTree T;
+		T.enableWal("walBenchmark.log", "walBenchmark.snap", window);
+		stringstream sink;
+		streambuf* original = cout.rdbuf(sink.rdbuf());
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < count; i++)
+		{
+			string ufid = to_string(10000000 + (int)(rng() % 100000));
+			if (i % 3 == 2)
+				T.remove(ufid);
+			else
+				T.insert("Student", ufid);
+			sink.str("");
+		}
+		T.disableWal();
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		cout.rdbuf(original);
+
+		cout << "group commit window " << setw(6) << window << " us: " << setw(9) << count / seconds << " durable commands/s" << endl;
+	}
+	std::remove("walBenchmark.log");
+	std::remove("walBenchmark.snap");
+	return 0;
+}
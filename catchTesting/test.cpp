@@ -1,6 +1,13 @@
 #include "AVL.h"
+#include "BinaryCommands.h"
+#include "CommandPipeline.h"
+#include "CommandServer.h"
+#include "LatencyHistogram.h"
+#include "MappedAVLTree.h"
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
+#include <csignal>
+#include <sys/resource.h>
 
 /*
 	To check output (At the Project1 directory):
@@ -83,3 +90,1074 @@ TEST_CASE("PerformsLeftRotationTest")
 
 
 
+// redirects cout into a string buffer until finish() or the end of the scope, so a failing REQUIRE or an exception
+// part way through a test never leaves cout captured for the tests after it
+class CoutCapture
+{
+	private:
+
+		ostringstream text;
+		streambuf* original;
+
+	public:
+
+		CoutCapture() : original(cout.rdbuf(text.rdbuf())) {}
+		~CoutCapture() { finish(); }
+		CoutCapture(const CoutCapture&) = delete;
+		CoutCapture& operator=(const CoutCapture&) = delete;
+
+		// what was printed since construction or the last clear()
+		string str() const { return text.str(); }
+		void clear() { text.str(""); }
+
+		// puts cout back (once) and returns what was printed; resume() captures again
+		string finish()
+		{
+			if (original != nullptr)
+			{
+				cout.rdbuf(original);
+				original = nullptr;
+			}
+			return text.str();
+		}
+		void resume()
+		{
+			if (original == nullptr)
+			{
+				original = cout.rdbuf(text.rdbuf());
+			}
+		}
+};
+
+
+// Test 6: prefix and case-insensitive name searches stay in sync with inserts and removes (including two-children removal);
+// a searchPrefix limit too large for an int is unsuccessful
+TEST_CASE("NamePrefixSearchTest")
+{
+	AVLTree T;
+	CoutCapture out;
+	T.insert("John Smith", "00000002");
+	T.insert("johanna Lee", "00000001");
+	T.insert("Mary", "00000003");
+	T.insert("JOHN SMITH", "00000004");
+	T.remove("00000002");
+	out.clear();
+	T.searchNamePrefix("joh");
+	T.searchNameIgnoreCase("john smith");
+	executeCommand(T, "searchPrefix \"J\" 1");
+	executeCommand(T, "searchPrefix \"J\" 99999999999");
+	out.finish();
+	REQUIRE(out.str() == "\"johanna Lee\" 00000001\n\"JOHN SMITH\" 00000004\n00000004\n\"johanna Lee\" 00000001\nunsuccessful\n");
+}
+
+
+// Test 7: the ufid filter answers every absent search either as a filter hit or a counted false positive
+TEST_CASE("IdFilterNegativeLookupTest")
+{
+	AVLTree T;
+	CoutCapture out;
+	T.enableIdFilter(16);
+	for (int i = 1; i <= 50; i++)
+	{
+		T.insert("mike", to_string(10000000 + i));
+	}
+	out.clear();
+	for (int i = 1; i <= 50; i++)
+	{
+		T.searchId(to_string(20000000 + i));
+	}
+	T.searchId("10000007");
+	out.finish();
+	IdFilter::Stats stats = T.idFilterStats();
+	REQUIRE(stats.queries == 51);
+	REQUIRE(stats.negatives + stats.falsePositives == 50);
+	REQUIRE(out.str().substr(out.str().size() - 5) == "mike\n");
+
+	// removed ufids stay in the filter until it is rebuilt, so removing or searching them again is a false positive
+	// every time, whether the miss comes from the tree or from the hybrid hash table
+	for (bool hashed : {false, true})
+	{
+		AVLTree H;
+		CoutCapture quiet;
+		if (hashed)
+			H.enableIdHash();
+		H.enableIdFilter(64);
+		for (int i = 1; i <= 50; i++)
+		{
+			H.insert("mike", to_string(10000000 + i));
+		}
+		for (int i = 1; i <= 20; i++)
+		{
+			H.remove(to_string(10000000 + i));
+		}
+		for (int i = 1; i <= 20; i++)
+		{
+			H.remove(to_string(10000000 + i));
+			H.searchId(to_string(10000000 + i));
+		}
+		quiet.finish();
+		IdFilter::Stats missed = H.idFilterStats();
+		REQUIRE(missed.queries == 60);
+		REQUIRE(missed.negatives == 0);
+		REQUIRE(missed.falsePositives == 40);
+		REQUIRE(missed.falsePositiveRate() == 1.0);
+	}
+}
+
+
+// Test 8: the searchId cache serves repeated searches and is invalidated when a two-children removal copies successor data
+TEST_CASE("IdCacheInvalidationTest")
+{
+	AVLTree T;
+	CoutCapture out;
+	T.enableIdCache(64);
+	T.insert("Michael", "00000002");
+	T.insert("Jordan", "00000001");
+	T.insert("Adam", "00000003");
+	T.searchId("00000002");
+	T.searchId("00000003");
+	T.searchId("00000002");
+	T.remove("00000002");
+	out.clear();
+	T.searchId("00000002");
+	T.searchId("00000003");
+	out.finish();
+	REQUIRE(T.idCacheStats().hits == 1);
+	REQUIRE(out.str() == "unsuccessful\nAdam\n");
+}
+
+
+// Test 9: the open-addressing ufid table agrees with std::map through random puts and backward-shift erases
+TEST_CASE("IdHashIndexMatchesMapTest")
+{
+	IdHashIndex<int> table;
+	map<int, int> expected;
+	unsigned seed = 12345;
+	for (int i = 0; i < 20000; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		int key = (int)(seed % 3000);
+		if (seed & 0x10000)
+		{
+			table.put(key, i);
+			expected[key] = i;
+		}
+		else
+		{
+			REQUIRE(table.erase(key) == (expected.erase(key) == 1));
+		}
+	}
+	REQUIRE(table.size() == expected.size());
+	for (int key = 0; key < 3000; key++)
+	{
+		int value = -1;
+		REQUIRE(table.find(key, value) == (expected.count(key) == 1));
+		if (expected.count(key) == 1)
+		{
+			REQUIRE(value == expected[key]);
+		}
+	}
+}
+
+
+// Test 10: hybrid hash mode answers searchId / remove from the hash table while range searches still walk the tree in order;
+// a range bound that overflows a key is unsuccessful
+TEST_CASE("HybridHashModeTest")
+{
+	AVLTree T;
+	CoutCapture out;
+	T.enableIdHash();
+	T.insert("Michael", "00000002");
+	T.insert("Jordan", "00000001");
+	T.insert("Adam", "00000003");
+	T.insert("Zoe", "00000004");
+	T.remove("00000002");
+	out.clear();
+	T.searchId("00000003");
+	T.searchId("00000002");
+	T.remove("00000009");
+	T.searchRange("00000001", "00000003");
+	executeCommand(T, "searchRange 1 99999999999");
+	executeCommand(T, "searchRange 99999999999 1");
+	out.finish();
+	REQUIRE(out.str() == "Adam\nunsuccessful\nunsuccessful\n\"Jordan\" 00000001\n\"Adam\" 00000003\nunsuccessful\nunsuccessful\n");
+}
+
+
+// checks parent pointers, stored heights, key order and AVL balance below "node"; returns the subtree height
+template <typename Node>
+int checkSubtree(Node* node, Node* parent)
+{
+	if (node == nullptr)
+	{
+		return 0;
+	}
+	REQUIRE(node->parent == parent);
+	if (node->left != nullptr)
+		REQUIRE(node->left->key < node->key);
+	if (node->right != nullptr)
+		REQUIRE(node->right->key > node->key);
+	int leftHeight = checkSubtree(node->left, node);
+	int rightHeight = checkSubtree(node->right, node);
+	REQUIRE(node->height == max(leftHeight, rightHeight) + 1);
+	REQUIRE(abs(leftHeight - rightHeight) <= 1);
+	return node->height;
+}
+
+
+// Test 11: iterative insert / remove keep parent pointers and stored heights consistent and the tree balanced
+TEST_CASE("ParentPointersAndRetraceTest")
+{
+	AVLTree T;
+	CoutCapture out;
+	unsigned seed = 99;
+	for (int i = 0; i < 3000; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		string ufid = to_string(10000000 + (seed >> 8) % 2000);
+		if (i % 3 == 2)
+			T.remove(ufid);
+		else
+			T.insert("mike", ufid);
+	}
+	out.finish();
+	checkSubtree(T.root, (decltype(T.root))nullptr);
+}
+
+
+// Test 12: a binary snapshot reloads into the identical shape, and the name index is rebuilt with it
+TEST_CASE("SnapshotRoundTripTest")
+{
+	AVLTree T;
+	CoutCapture out;
+	for (int i = 1; i <= 200; i++)
+	{
+		T.insert("Student " + string(1, (char)('A' + i % 26)), to_string(10000000 + (i * 7919) % 100000));
+	}
+	T.remove(T.root->ufid);
+	REQUIRE(T.saveSnapshot("snapshotTest.bin"));
+	out.clear();
+	T.printPreorder();
+	string before = out.str();
+
+	AVLTree loaded;
+	REQUIRE(loaded.loadSnapshot("snapshotTest.bin"));
+	out.clear();
+	loaded.printPreorder();
+	string after = out.str();
+	out.clear();
+	loaded.searchNamePrefix("student z", 1);
+	out.finish();
+	std::remove("snapshotTest.bin");
+
+	REQUIRE(before == after);
+	REQUIRE(loaded.height(loaded.root) == T.height(T.root));
+	checkSubtree(loaded.root, (decltype(loaded.root))nullptr);
+	REQUIRE(out.str().substr(0, 11) == "\"Student Z\"");
+}
+
+
+// Test 13: recovery replays the log over the last checkpoint and ignores a record torn by a crash; an update the log
+// cannot record is refused
+TEST_CASE("WriteAheadLogRecoveryTest")
+{
+	std::remove("walTest.log");
+	std::remove("walTest.snap");
+	CoutCapture out;
+	{
+		AVLTree T;
+		REQUIRE(T.enableWal("walTest.log", "walTest.snap", 0));
+		T.insert("Jordan", "00000001");
+		T.insert("Michael", "00000002");
+		REQUIRE(T.checkpoint());
+		T.insert("Adam", "00000003");
+		T.remove("00000001");
+		T.removeInorder(0);
+	}
+
+	// simulate a crash in the middle of writing one more record
+	ofstream torn("walTest.log", ios::binary | ios::app);
+	torn.write("\x20\x00\x00\x00\x01", 5);
+	torn.close();
+
+	AVLTree recovered;
+	REQUIRE(recovered.enableWal("walTest.log", "walTest.snap", 0));
+	out.clear();
+	recovered.printInorder();
+	recovered.insert("Zoe", "00000004");
+	out.finish();
+	recovered.disableWal();
+	std::remove("walTest.log");
+	std::remove("walTest.snap");
+	REQUIRE(out.str() == "Adam\nsuccessful\n");
+
+	// loadSnapshot replaces the whole tree while logging, so the records after it must replay onto the loaded tree
+	CoutCapture loadOutput;
+	{
+		AVLTree saved;
+		saved.insert("Ann", "11111111");
+		saved.insert("Bob", "22222222");
+		REQUIRE(saved.saveSnapshot("walLoad.saved"));
+	}
+	{
+		AVLTree T;
+		REQUIRE(T.enableWal("walTest.log", "walTest.snap", 0));
+		T.insert("Cat", "33333333");
+		REQUIRE(T.loadSnapshot("walLoad.saved"));
+		T.remove("11111111");
+	}
+	AVLTree restarted;
+	REQUIRE(restarted.enableWal("walTest.log", "walTest.snap", 0));
+	loadOutput.clear();
+	restarted.printInorder();
+	loadOutput.finish();
+	restarted.disableWal();
+	std::remove("walTest.log");
+	std::remove("walTest.snap");
+	std::remove("walLoad.saved");
+	REQUIRE(loadOutput.str() == "Bob\n");
+
+	// a load that fails (no file, bad magic, cut short) leaves the tree and the log alone
+	{
+		AVLTree saved;
+		saved.insert("Eve", "55555555");
+		saved.insert("Fay", "66666666");
+		REQUIRE(saved.saveSnapshot("walLoad.saved"));
+	}
+	ifstream whole("walLoad.saved", ios::binary);
+	string snapshot((istreambuf_iterator<char>(whole)), istreambuf_iterator<char>());
+	whole.close();
+	ofstream("walLoad.bad", ios::binary) << "AVLX" << snapshot.substr(4);
+	ofstream("walLoad.cut", ios::binary) << snapshot.substr(0, snapshot.size() - 2);
+	CoutCapture failedOutput;
+	{
+		AVLTree T;
+		REQUIRE(T.enableWal("walTest.log", "walTest.snap", 0));
+		T.insert("Dan", "44444444");
+		REQUIRE_FALSE(T.loadSnapshot("walLoad.missing"));
+		REQUIRE_FALSE(T.loadSnapshot("walLoad.bad"));
+		REQUIRE_FALSE(T.loadSnapshot("walLoad.cut"));
+		T.insert("Gus", "77777777");
+		T.printInorder();
+	}
+	AVLTree survived;
+	REQUIRE(survived.enableWal("walTest.log", "walTest.snap", 0));
+	survived.printInorder();
+	failedOutput.finish();
+	survived.disableWal();
+	std::remove("walTest.log");
+	std::remove("walTest.snap");
+	std::remove("walLoad.saved");
+	std::remove("walLoad.bad");
+	std::remove("walLoad.cut");
+	REQUIRE(failedOutput.str() == "successful\nsuccessful\nDan, Gus\nDan, Gus\n");
+
+	// an update the log cannot record (cut short here by the file size limit) is refused and not made, and its partial
+	// record is cut back off, so the records appended after it still replay
+	void (*previousHandler)(int) = signal(SIGXFSZ, SIG_IGN);
+	rlimit limits;
+	REQUIRE(getrlimit(RLIMIT_FSIZE, &limits) == 0);
+	for (bool hashed : {false, true})
+	{
+		CoutCapture refusedOutput;
+		{
+			AVLTree T;
+			if (hashed)
+				T.enableIdHash();
+			REQUIRE(T.enableWal("walTest.log", "walTest.snap", 0));
+			T.insert("Hal", "88888888");
+			struct stat logInfo;
+			REQUIRE(stat("walTest.log", &logInfo) == 0);
+			rlimit tight = limits;
+			tight.rlim_cur = (rlim_t)logInfo.st_size + 10;
+			REQUIRE(setrlimit(RLIMIT_FSIZE, &tight) == 0);
+			T.insert("Ivy", "99999999");
+			T.remove("88888888");
+			T.removeInorder(0);
+			REQUIRE(setrlimit(RLIMIT_FSIZE, &limits) == 0);
+			T.insert("Jay", "12121212");
+			T.printInorder();
+		}
+		AVLTree reopened;
+		REQUIRE(reopened.enableWal("walTest.log", "walTest.snap", 0));
+		reopened.printInorder();
+		refusedOutput.finish();
+		reopened.disableWal();
+		std::remove("walTest.log");
+		std::remove("walTest.snap");
+		REQUIRE(refusedOutput.str() == "successful\nunsuccessful\nunsuccessful\nunsuccessful\nsuccessful\nJay, Hal\nJay, Hal\n");
+	}
+	signal(SIGXFSZ, previousHandler);
+
+	// the last records of a burst are synced once the group commit window has passed, with no further append
+	std::remove("walTest.log");
+	WriteAheadLog log;
+	REQUIRE(log.open("walTest.log", chrono::microseconds(50000)));
+	REQUIRE(log.append(WriteAheadLog::Insert, "00000001", "Jordan"));
+	REQUIRE(log.append(WriteAheadLog::Insert, "00000002", "Michael"));
+	this_thread::sleep_for(chrono::milliseconds(500));
+	REQUIRE(log.recordsAppended() == 2);
+	REQUIRE(log.syncCount() == 1);
+	log.close();
+	std::remove("walTest.log");
+}
+
+
+// Test 14: the memory-mapped tree keeps its contents across close / reopen and answers range scans from the file
+TEST_CASE("MappedTreeReopenTest")
+{
+	std::remove("mappedTest.avl");
+	std::remove("mappedTest.avl.names");
+	{
+		MappedAVLTree M;
+		REQUIRE(M.open("mappedTest.avl"));
+		for (int i = 0; i < 5000; i++)
+		{
+			REQUIRE(M.insertStudent("Student" + to_string(i), to_string(10000000 + i)));
+		}
+		REQUIRE_FALSE(M.insertStudent("Duplicate", "10000042"));
+		for (int i = 0; i < 5000; i += 2)
+		{
+			REQUIRE(M.removeStudent(to_string(10000000 + i)));
+		}
+	}
+
+	MappedAVLTree reopened;
+	REQUIRE(reopened.open("mappedTest.avl"));
+	string name;
+	REQUIRE(reopened.size() == 2500);
+	REQUIRE(reopened.findStudent("10000043", name));
+	REQUIRE(name == "Student43");
+	REQUIRE_FALSE(reopened.findStudent("10000042", name));
+	REQUIRE(reopened.height() <= 17);
+
+	vector<string> inRange;
+	reopened.scanRange(10000010, 10000020, [&](const string& ufid, const string&) { inRange.push_back(ufid); });
+	REQUIRE(inRange == vector<string>({"10000011", "10000013", "10000015", "10000017", "10000019"}));
+	reopened.close();
+	std::remove("mappedTest.avl");
+	std::remove("mappedTest.avl.names");
+}
+
+
+// Test 15: operation counters see every insert, duplicate, remove, rotation type and search descent
+TEST_CASE("OperationStatsTest")
+{
+	AVLTree T;
+	T.insert("A", "00000003");
+	T.insert("B", "00000002");
+	T.insert("C", "00000001");	// left-left -> rotateRight
+	T.insert("D", "00000004");
+	T.insert("E", "00000005");	// right-right -> rotateLeft
+	T.insert("F", "00000007");
+	T.insert("G", "00000006");	// right-left -> rotateRightLeft
+	T.insert("H", "00000006");	// duplicate
+	T.remove("00000001");
+	T.searchId("00000002");
+	T.searchId("00000099");
+
+	TreeStats::Snapshot stats = T.stats();
+	REQUIRE(stats.inserts == 7);
+	REQUIRE(stats.duplicateInserts == 1);
+	REQUIRE(stats.removes == 1);
+	REQUIRE(stats.rotateRight == 1);
+	REQUIRE(stats.rotateLeft >= 1);
+	REQUIRE(stats.rotateRightLeft == 1);
+	REQUIRE(stats.searches == 2);
+	REQUIRE(stats.searchVisits >= 2);
+	REQUIRE(stats.visitsPerSearch() <= T.height(T.root));
+
+	T.resetStats();
+	REQUIRE(T.stats().inserts == 0);
+}
+
+
+// Test 16: the latency histogram reports percentiles within its bucket precision (1/32) and the exact max
+TEST_CASE("LatencyHistogramPercentileTest")
+{
+	LatencyHistogram histogram;
+	for (uint64_t value = 1; value <= 100000; value++)
+	{
+		histogram.record(value);
+	}
+	REQUIRE(histogram.count() == 100000);
+	REQUIRE(histogram.max() == 100000);
+	REQUIRE(histogram.percentile(0) == 1);
+	REQUIRE(histogram.percentile(1.0) == 100000);
+
+	uint64_t median = histogram.percentile(0.5);
+	uint64_t tail = histogram.percentile(0.99);
+	REQUIRE(median >= 50000);
+	REQUIRE(median <= 50000 + 50000 / 32);
+	REQUIRE(tail >= 99000);
+	REQUIRE(tail <= 100000);
+
+	// small values each get an exact bucket
+	LatencyHistogram exact;
+	exact.record(3);
+	exact.record(7);
+	REQUIRE(exact.percentile(0.25) == 3);
+	REQUIRE(exact.percentile(0.75) == 7);
+}
+
+
+// Test 17: analyze reports the shape of a known tree and counts heap storage for long names only
+TEST_CASE("TreeAnalysisTest")
+{
+	AVLTree T;
+	REQUIRE(T.analyze().nodeCount == 0);
+
+	// 7 sorted inserts rebalance into a perfect tree of height 3
+	for (int i = 1; i <= 7; i++)
+	{
+		T.insert("N", "0000000" + to_string(i));
+	}
+	AVLTree::Analysis report = T.analyze();
+	REQUIRE(report.nodeCount == 7);
+	REQUIRE(report.height == 3);
+	REQUIRE(report.optimalHeight == 3);
+	REQUIRE(report.maxDepth == 3);
+	REQUIRE(report.averageDepth == Approx(17.0 / 7));
+	REQUIRE(report.balanceCounts[1] == 7);
+	REQUIRE(report.unbalancedNodes == 0);
+	REQUIRE(report.nodeBytes >= 7 * 100);
+	REQUIRE(report.stringBytes == 0);
+
+	T.insert("A Name Far Too Long For Small String Storage", "00000008");
+	report = T.analyze();
+	REQUIRE(report.nodeCount == 8);
+	REQUIRE(report.stringBytes > 0);
+	REQUIRE(report.balanceCounts[0] + report.balanceCounts[1] + report.balanceCounts[2] == 8);
+}
+
+
+// Test 18: remove reports found / not found from its single descent (including removing the last node), and heavy
+// churn keeps the height within the AVL bound of 1.44 log2(n + 2)
+TEST_CASE("RemoveStatusAndChurnTest")
+{
+	AVLTree T;
+	CoutCapture output;
+	T.insert("A", "00000001");
+	T.remove("00000002");
+	T.remove("00000001");
+	T.remove("00000001");
+	output.finish();
+	REQUIRE(output.str() == "successful\nunsuccessful\nsuccessful\nunsuccessful\n");
+	REQUIRE(T.root == nullptr);
+
+	CoutCapture discarded;
+	unsigned state = 7;
+	for (int round = 0; round < 20000; round++)
+	{
+		state = state * 1103515245u + 12345u;
+		string ufid = to_string(10000000 + (state >> 8) % 4000);
+		if (round % 3 == 0)
+			T.remove(ufid);
+		else
+			T.insert("Churn", ufid);
+		discarded.clear();
+	}
+	discarded.finish();
+
+	AVLTree::Analysis report = T.analyze();
+	REQUIRE(report.unbalancedNodes == 0);
+	REQUIRE(report.height <= 1.44 * log2(report.nodeCount + 2));
+	REQUIRE(T.stats().removes + report.nodeCount == T.stats().inserts);
+}
+
+
+// Test 19: tombstoned students disappear from every search and traversal, can be re-inserted, and compaction
+// rebuilds a balanced tree from the live nodes only
+TEST_CASE("TombstoneCompactionTest")
+{
+	AVLTree T;
+	T.enableTombstones(0.5);
+	CoutCapture output;
+	for (int i = 0; i < 100; i++)
+	{
+		T.insert("Student", to_string(10000000 + i));
+	}
+	for (int i = 0; i < 40; i++)
+	{
+		T.remove(to_string(10000000 + i));
+	}
+	REQUIRE(T.tombstoneCount() == 40);
+	REQUIRE(T.stats().rotateLeft + T.stats().rotateRight + T.stats().rotateLeftRight + T.stats().rotateRightLeft > 0);
+	TreeStats::Snapshot before = T.stats();
+
+	output.clear();
+	T.remove("10000005");
+	T.searchId("10000005");
+	T.searchId("10000050");
+	T.searchRange("10000000", "10000041");
+	REQUIRE(output.str() == "unsuccessful\nunsuccessful\nStudent\n\"Student\" 10000040\n\"Student\" 10000041\n");
+
+	T.inorderVec.clear();
+	T.inorder(T.root);
+	REQUIRE(T.inorderVec.size() == 60);
+	REQUIRE(T.inorderVec[0]->ufid == "10000040");
+
+	// re-inserting a tombstoned ufid revives its node
+	T.insert("Back Again", "10000003");
+	output.clear();
+	T.searchId("10000003");
+	REQUIRE(output.str() == "Back Again\n");
+	REQUIRE(T.tombstoneCount() == 39);
+
+	// tombstoning caused no rotations; passing the threshold compacts
+	REQUIRE(T.stats().rotateLeft == before.rotateLeft);
+	for (int i = 41; i < 80; i++)
+	{
+		T.remove(to_string(10000000 + i));
+	}
+	output.finish();
+	REQUIRE(T.stats().compactions >= 1);
+	AVLTree::Analysis report = T.analyze();
+	REQUIRE(report.tombstones <= 0.5 * report.nodeCount);
+	REQUIRE(report.tombstones == T.tombstoneCount());
+	REQUIRE(report.height <= 1.44 * log2(report.nodeCount + 2));
+	REQUIRE(report.unbalancedNodes == 0);
+
+	T.disableTombstones();
+	REQUIRE(T.tombstoneCount() == 0);
+	T.inorderVec.clear();
+	T.inorder(T.root);
+	REQUIRE(T.inorderVec.size() == T.analyze().nodeCount);
+}
+
+
+// Test 20: visitor traversals see every student in the right order, and stop as soon as the visitor returns false
+TEST_CASE("VisitorTraversalTest")
+{
+	AVLTree T;
+	CoutCapture output;
+	for (int i : {4, 2, 6, 1, 3, 5, 7})
+	{
+		T.insert("S" + to_string(i), "0000000" + to_string(i));
+	}
+	output.finish();
+
+	string inorder;
+	string preorder;
+	string postorder;
+	REQUIRE(T.forEachInorder([&](const AVLTree::NodeView& student) { inorder += student.name; return true; }));
+	REQUIRE(T.forEachPreorder([&](const AVLTree::NodeView& student) { preorder += student.name; return true; }));
+	REQUIRE(T.forEachPostorder([&](const AVLTree::NodeView& student) { postorder += student.name; return true; }));
+	REQUIRE(inorder == "S1S2S3S4S5S6S7");
+	REQUIRE(preorder == "S4S2S1S3S6S5S7");
+	REQUIRE(postorder == "S1S3S2S5S7S6S4");
+
+	// early termination after the third student
+	vector<int> keys;
+	REQUIRE_FALSE(T.forEachInorder([&](const AVLTree::NodeView& student) { keys.push_back(student.key); return keys.size() < 3; }));
+	REQUIRE(keys == vector<int>({1, 2, 3}));
+
+	// an empty tree visits nothing
+	AVLTree empty;
+	int visits = 0;
+	REQUIRE(empty.forEachPostorder([&](const AVLTree::NodeView&) { visits++; return true; }));
+	REQUIRE(visits == 0);
+}
+
+
+// Test 21: the parallel export writes exactly what printInorder prints, for any thread count and with tombstones
+TEST_CASE("ParallelExportTest")
+{
+	AVLTree T;
+	CoutCapture output;
+	for (int i = 0; i < 5000; i++)
+	{
+		T.insert("Student" + to_string(i * 7919 % 5000), to_string(10000000 + i * 7919 % 5000));
+	}
+	T.enableTombstones(0.9);
+	for (int i = 0; i < 5000; i += 3)
+	{
+		T.remove(to_string(10000000 + i));
+	}
+	output.clear();
+	T.printInorder();
+	output.finish();
+	string expected = output.str();
+
+	for (unsigned threads : {1u, 2u, 3u, 8u})
+	{
+		ostringstream exported;
+		T.exportInorder(exported, threads);
+		REQUIRE(exported.str() == expected);
+	}
+
+	// an empty tree exports nothing, and a single student needs no separator
+	AVLTree small;
+	ostringstream empty;
+	small.exportInorder(empty, 4);
+	REQUIRE(empty.str() == "");
+	output.resume();
+	small.insert("Solo", "12345678");
+	output.finish();
+	ostringstream single;
+	small.exportInorder(single, 4);
+	REQUIRE(single.str() == "Solo\n");
+}
+
+
+// Test 22: the bulk constructor builds the same roster as running the insert commands one by one (first occurrence of
+// a ufid wins, rows insert rejects are dropped), in a perfectly balanced shape, for any thread count
+TEST_CASE("ParallelBulkBuildTest")
+{
+	// names spell the row number in letters; every seventh row has a digit in its name, a 9-digit ufid or a letter in it
+	vector<pair<string, string>> students;
+	for (int i = 0; i < 60000; i++)
+	{
+		int key = (i * 7919) % 40000;
+		string name = "Student ";
+		for (char digit : to_string(i))
+		{
+			name += (char)('a' + (digit - '0'));
+		}
+		string ufid = to_string(10000000 + key);
+		if (i % 7 == 3)
+		{
+			if (i % 3 == 0)
+				name += "7";
+			else if (i % 3 == 1)
+				ufid += "0";
+			else
+				ufid[4] = 'x';
+		}
+		students.push_back(make_pair(name, ufid));
+	}
+
+	AVLTree inserted;
+	CoutCapture output;
+	for (const auto& student : students)
+	{
+		executeCommand(inserted, "insert \"" + student.first + "\" " + student.second);
+	}
+	output.clear();
+	inserted.printInorder();
+	string expected = output.str();
+	output.finish();
+
+	for (unsigned threads : {1u, 3u, 8u})
+	{
+		AVLTree T(students, threads);
+		ostringstream exported;
+		T.exportInorder(exported, 1);
+		REQUIRE(exported.str() == expected);
+
+		AVLTree::Analysis report = T.analyze();
+		REQUIRE(report.nodeCount == inserted.analyze().nodeCount);
+		REQUIRE(report.height == report.optimalHeight);
+		REQUIRE(report.unbalancedNodes == 0);
+		REQUIRE(T.stats().inserts == inserted.stats().inserts);
+		REQUIRE(T.stats().duplicateInserts == inserted.stats().duplicateInserts);
+
+		// the name index and parent links are usable straight away
+		output.resume();
+		output.clear();
+		T.searchNamePrefix("Student djjjj");
+		T.remove("10000000");
+		T.insert("Late", "10000000");
+		output.finish();
+		REQUIRE(output.str() == "\"Student djjjj\" " + to_string(10000000 + (39999 * 7919) % 40000) + "\nsuccessful\nsuccessful\n");
+		REQUIRE(T.analyze().unbalancedNodes == 0);
+	}
+
+	AVLTree empty(vector<pair<string, string>>(), 4);
+	REQUIRE(empty.root == nullptr);
+}
+
+
+#if defined(__cpp_impl_coroutine)
+// Test 23 (built with -std=c++20): generator traversals yield the same students as the visitor traversals, skip
+// tombstones, and can be abandoned or interleaved part way
+TEST_CASE("GeneratorTraversalTest")
+{
+	AVLTree T;
+	CoutCapture output;
+	for (int i = 0; i < 300; i++)
+	{
+		T.insert("S" + to_string(i * 37 % 300), to_string(10000000 + i * 37 % 300));
+	}
+	T.enableTombstones(0.9);
+	T.remove("10000007");
+	output.finish();
+
+	vector<string> expected[3];
+	vector<string> generated[3];
+	T.forEachInorder([&](const AVLTree::NodeView& student) { expected[0].push_back(student.name); return true; });
+	T.forEachPreorder([&](const AVLTree::NodeView& student) { expected[1].push_back(student.name); return true; });
+	T.forEachPostorder([&](const AVLTree::NodeView& student) { expected[2].push_back(student.name); return true; });
+	for (const AVLTree::NodeView& student : T.generateInorder())
+		generated[0].push_back(student.name);
+	for (const AVLTree::NodeView& student : T.generatePreorder())
+		generated[1].push_back(student.name);
+	for (const AVLTree::NodeView& student : T.generatePostorder())
+		generated[2].push_back(student.name);
+	for (int order = 0; order < 3; order++)
+	{
+		REQUIRE(generated[order] == expected[order]);
+		REQUIRE(generated[order].size() == 299);
+	}
+
+	// take the first three, then interleave an inorder and a postorder walk step by step
+	vector<int> keys;
+	for (const AVLTree::NodeView& student : T.generateInorder())
+	{
+		keys.push_back(student.key);
+		if (keys.size() == 3)
+			break;
+	}
+	REQUIRE(keys == vector<int>({10000000, 10000001, 10000002}));
+
+	Generator<AVLTree::NodeView> inorder = T.generateInorder();
+	Generator<AVLTree::NodeView> postorder = T.generatePostorder();
+	auto in = inorder.begin();
+	auto post = postorder.begin();
+	for (int i = 0; i < 299; i++, ++in, ++post)
+	{
+		REQUIRE(in->name == expected[0][i]);
+		REQUIRE(post->name == expected[2][i]);
+	}
+	REQUIRE(in == default_sentinel);
+	REQUIRE(post == default_sentinel);
+
+	AVLTree empty;
+	REQUIRE(empty.generatePostorder().begin() == default_sentinel);
+}
+#endif
+
+
+// Test 24: the pipelined driver prints exactly what running the same lines one by one prints, for any batch size,
+// including lines whose numbers do not convert (answered "unsuccessful" by both)
+TEST_CASE("PipelinedExecutionTest")
+{
+	const char* malformed[] = {"bogus", "removeInorder", "removeInorder x", "remove abc", "search 99999999999"};
+	vector<string> lines;
+	for (int i = 0; i < 3000; i++)
+	{
+		string ufid = to_string(10000000 + i * 7 % 1000);
+		switch (i % 6)
+		{
+			case 0: lines.push_back("insert \"Student" + string(1, (char)('a' + i % 26)) + "\" " + ufid); break;
+			case 1: lines.push_back("search " + ufid); break;
+			case 2: lines.push_back("remove " + to_string(10000000 + i % 1000)); break;
+			case 3: lines.push_back(i % 60 == 3 ? "printInorder" : "insert \"Bad1\" " + ufid); break;
+			case 4: lines.push_back(i % 120 == 4 ? "printLevelCount" : malformed[i / 6 % 5]); break;
+			default: lines.push_back("searchRange 10000000 10000050"); break;
+		}
+	}
+
+	streambuf* console = cout.rdbuf();
+	AVLTree sequential;
+	CoutCapture expected;
+	for (const string& line : lines)
+	{
+		executeCommand(sequential, line);
+	}
+	expected.finish();
+
+	string input;
+	for (const string& line : lines)
+	{
+		input += line + "\n";
+	}
+	for (size_t batch : {1, 7, 256, 5000})
+	{
+		AVLTree T;
+		istringstream in(input);
+		ostringstream out;
+		runPipelined(T, in, (long long)lines.size(), out, batch);
+		REQUIRE(out.str() == expected.str());
+		REQUIRE(cout.rdbuf() == console);
+	}
+}
+
+
+// Test 25: server mode answers two clients over a Unix socket, one '\0'-terminated reply per line and in each client's
+// order, against one shared tree; a line whose number does not convert is answered "unsuccessful" and the connection
+// carries on
+TEST_CASE("UnixSocketServerTest")
+{
+	AVLTree T;
+	string path = "/tmp/avl_server_test_" + to_string(getpid()) + ".sock";
+	CommandServer server(T, path);
+	REQUIRE(server.open());
+	thread loop([&server] { server.run(); });
+
+	auto converse = [&path](const string& requests)
+	{
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		sockaddr_un address;
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+		string replies;
+		if (connect(fd, (sockaddr*)&address, sizeof(address)) == 0 && write(fd, requests.data(), requests.size()) == (ssize_t)requests.size())
+		{
+			shutdown(fd, SHUT_WR);
+			char buffer[4096];
+			ssize_t count;
+			while ((count = read(fd, buffer, sizeof(buffer))) > 0)
+			{
+				replies.append(buffer, (size_t)count);
+			}
+		}
+		close(fd);
+		return replies;
+	};
+
+	string first = converse("printInorder\ninsert \"Ada\" 12345678\ninsert \"Bo\" 12345677\r\ninsert \"C3\" 12345676\n");
+	string second = converse("search 12345678\nprintInorder\nprintLevelCount\nbogus\nsearch \"Bo\"\npartial line without newline");
+	string third = converse("removeInorder\nremoveInorder x\nsearch 12345678\n");
+	string fourth = converse("search 12345677\n");
+	server.requestStop();
+	loop.join();
+
+	auto framed = [](const vector<string>& replies)
+	{
+		string joined;
+		for (const string& reply : replies)
+		{
+			joined += reply + '\0';
+		}
+		return joined;
+	};
+	REQUIRE(first == framed({"", "successful\n", "successful\n", "unsuccessful\n"}));
+	REQUIRE(second == framed({"Ada\n", "Bo, Ada\n", "2\n\n", "unsuccessful\n", "12345677\n"}));
+	REQUIRE(third == framed({"unsuccessful\n", "unsuccessful\n", "Ada\n"}));
+	REQUIRE(fourth == framed({"Bo\n"}));
+	REQUIRE(server.stats().clients == 4);
+	REQUIRE(server.stats().commands == 13);
+}
+
+
+// Test 26: a text command stream converted to the binary format prints exactly what the text driver prints, keeping
+// leading zeros and falling back to raw lines for operands the records cannot hold; a truncated stream, an insert
+// record whose name or ufid the text parser would reject, or a ufid digit count outside 1 .. 9 is rejected
+TEST_CASE("BinaryCommandFormatTest")
+{
+	vector<string> lines = {"insert \"Ada\" 00001234", "insert \"Bo\" 12345677", "insert \"C3\" 12345676", "search 00001234",
+		"search \"Bo\"", "searchRange 00000000 99999999", "search 1234x678", "remove 12a4", "printInorder", "printPreorder",
+		"removeInorder 0", "printLevelCount", "bogus command", "insert \"Dee\" 12345699", "printPostorder", "removeInorder",
+		"remove abc", "search 99999999999"};
+
+	AVLTree textTree;
+	CoutCapture expected;
+	for (const string& line : lines)
+	{
+		executeCommand(textTree, line);
+	}
+	expected.finish();
+
+	string binary;
+	encodeBinaryHeader(lines.size(), binary);
+	for (const string& line : lines)
+	{
+		encodeCommandLine(line, binary);
+	}
+	AVLTree binaryTree;
+	CoutCapture actual;
+	bool ran = runBinaryCommands(binaryTree, binary.data(), binary.size());
+	actual.finish();
+	REQUIRE(ran);
+	REQUIRE(actual.str() == expected.str());
+
+	AVLTree truncatedTree;
+	CoutCapture ignored;
+	bool truncated = runBinaryCommands(truncatedTree, binary.data(), binary.size() - 1);
+	ignored.finish();
+	REQUIRE_FALSE(truncated);
+	REQUIRE_FALSE(runBinaryCommands(truncatedTree, "AVLX", 4));
+
+	// hand-edited insert records: a digit in the name, then a 9-digit ufid
+	string insert;
+	encodeBinaryHeader(1, insert);
+	encodeCommandLine("insert \"Ada\" 00001234", insert);
+	string badName = insert;
+	badName[binaryHeaderSize + binaryRecordHeaderSize] = '7';
+	string badUfid = insert;
+	badUfid[binaryHeaderSize + 1] = 9;
+	AVLTree craftedTree;
+	CoutCapture crafted;
+	bool nameRan = runBinaryCommands(craftedTree, badName.data(), badName.size());
+	bool ufidRan = runBinaryCommands(craftedTree, badUfid.data(), badUfid.size());
+	bool insertRan = runBinaryCommands(craftedTree, insert.data(), insert.size());
+	REQUIRE(crafted.finish() == "successful\n");
+	REQUIRE_FALSE(nameRan);
+	REQUIRE_FALSE(ufidRan);
+	REQUIRE(insertRan);
+
+	// digit counts the encoder never writes (byte 1 is the ufid's, byte 2 the high ufid's): none, past the 16-byte
+	// format buffer, and 10 digits holding a value beyond int
+	struct DigitCase { string line; size_t field; uint8_t digits; uint32_t value; };
+	vector<DigitCase> digitCases = {{"search 12345678", 1, 0, 12345678}, {"search 12345678", 1, 200, 12345678},
+		{"search 12345678", 1, 10, 4000000000u}, {"remove 12345678", 1, 16, 12345678},
+		{"searchRange 00000000 99999999", 1, 200, 0}, {"searchRange 00000000 99999999", 2, 200, 99999999},
+		{"searchRange 00000000 99999999", 2, 10, 4000000000u}};
+	for (const DigitCase& digitCase : digitCases)
+	{
+		string record;
+		encodeBinaryHeader(1, record);
+		encodeCommandLine(digitCase.line, record);
+		record[binaryHeaderSize + digitCase.field] = (char)digitCase.digits;
+		memcpy(&record[binaryHeaderSize + (digitCase.field == 1 ? 4 : 8)], &digitCase.value, 4);
+		CoutCapture rejected;
+		bool ran = runBinaryCommands(craftedTree, record.data(), record.size());
+		REQUIRE(rejected.finish() == "");
+		REQUIRE_FALSE(ran);
+	}
+}
+
+
+// Test 27: the vectorized name check accepts exactly what isalpha / isspace accept, for every byte value at every
+// position of names long enough to reach the 16- and 32-byte tails; the SWAR ufid check and conversion match
+// isdigit / stoi, and insert still rejects what it rejected before
+TEST_CASE("InputValidationTest")
+{
+	for (int value = 0; value < 256; value++)
+	{
+		bool expected = isalpha(value) || isspace(value);
+		for (size_t length = 1; length <= 70; length += 3)
+		{
+			for (size_t position = 0; position < length; position++)
+			{
+				string name(length, 'x');
+				name[position] = (char)value;
+				REQUIRE(validNameText(name) == expected);
+				REQUIRE(validNameTextScalar(name.data(), name.size()) == expected);
+			}
+		}
+	}
+	REQUIRE(validNameText(""));
+
+	mt19937 rng(27);
+	for (int i = 0; i < 100000; i++)
+	{
+		string ufid(8, '0');
+		bool digits = true;
+		for (char& c : ufid)
+		{
+			c = rng() % 4 == 0 ? (char)(rng() % 256) : (char)('0' + rng() % 10);
+			digits = digits && isdigit((unsigned char)c);
+		}
+		REQUIRE(validUfid(ufid) == digits);
+		if (digits)
+		{
+			REQUIRE(ufidKey(ufid) == stoi(ufid));
+		}
+	}
+	REQUIRE(parseEightDigits("00000000") == 0);
+	REQUIRE(parseEightDigits("99999999") == 99999999);
+	REQUIRE(parseEightDigits("01234567") == 1234567);
+	REQUIRE_FALSE(validUfid("1234567"));
+	REQUIRE_FALSE(validUfid("123456789"));
+	REQUIRE(ufidKey("123") == 123);
+	REQUIRE_THROWS(ufidKey("abc"));
+
+	REQUIRE(parseCommand("insert \"Ada Lovelace\" 12345678").op == ParsedCommand::Insert);
+	REQUIRE(parseCommand("insert \"Ada\tLovelace\" 00000001").op == ParsedCommand::Insert);
+	REQUIRE(parseCommand("insert \"Ada L.\" 12345678").op == ParsedCommand::Invalid);
+	REQUIRE(parseCommand("insert \"Ada\" 1234567a").op == ParsedCommand::Invalid);
+	REQUIRE(parseCommand("insert \"Ada\" 123456789").op == ParsedCommand::Invalid);
+}
@@ -1,166 +1,207 @@
-#include "AVL.h"
-using namespace std;
-
-int main() 
-{
-    string name;
-    string ufid;
-    string space = " ";
-    AVLTree T;
-
-    // read in first line and create variable for the number of commands (lineCount)
-    string line;
-    getline(cin, line);
-    int lineCount = stoi(line);
-
-    // for each command, execute it on the AVLTree T
-    for (int i = 0; i < lineCount; ++i)
-    {
-        // read current line, stop when a space reached, set the read string as the "command" to be called in the AVL Tree
-        getline(cin, line);          
-        string command = line.substr(0, line.find(space));
-
-        //============================ INSERT NAME ID ============================= //
-        if (command == "insert")
-        {
-            // bool variables for checking if the node can be inserted or not
-            bool validName = true;
-            bool validId = true;
-
-            // erase line until just after first double quote, set name equal to the substring from line(0) until the second double quote
-            line.erase(0, line.find(space) + 2);
-            name = line.substr(0,line.find("\""));
-
-
-            // for each character in name, check if its a letter or space
-            for (char c : name)
-            {
-                if(!isalpha(c) && !isspace(c))
-                {
-                    // if a character in "name" is not a letter, invalid name -> cannot insert
-                    validName = false;
-                }
-            }
-            
-            // get ufid number from continuing input parsing
-            line.erase(0, name.length() + 2);
-            ufid = line.substr(0, line.find(space));
-
-
-            // check number of digits in ufid
-            if(ufid.length() != 8)
-            {
-                // if ufid doesn't contain exactly 8 digits, invalid ufid -> cannot insert
-                validId = false;
-            }
-            
-            // for each char in ufid, check if its a digit
-            for (char c : ufid)
-            {
-                if(!isdigit(c))
-                {
-                    // if a character in "ufid" is not a digit, invalid ufid -> cannot insert
-                    validId = false;
-                }
-            }
-
-            if (validName && validId)
-            {
-                // if input for name and ufid are valid, insert node into AVLTree "T"
-                T.insert(name,ufid);
-            }
-            else
-            {
-                // else, display "unsuccessful"
-                cout << T.unsuccess << endl;
-            }
-
-        }
-
-        //============================ REMOVE ID ============================= //
-        else if (command == "remove")
-        {
-            // erase line until the first digit of the ufid, set ufid to be the string until the next space is reached
-            line.erase(0, line.find(space) + 1);
-            ufid = line.substr(0, line.find(space));
-
-            // call to remove function in AVLTree class...
-            T.remove(ufid);
-        }
-
-        //============================ REMOVEINORDER N ============================= //
-        else if (command == "removeInorder")
-        {
-            // erase line until the digit of n, set n to be the string until the next space is reached
-            line.erase(0, line.find(space) + 1);
-            string n = line.substr(0, line.find(space));
-
-            // call to removeInorder function in AVLTree class
-            T.removeInorder(stoi(n));
-
-        }
-
-        //============================ SEARCH COMMANDS ============================= //
-        else if (command == "search")
-        {
-            // erase line until the first character after the space, set readline to be the string until the next space is reached
-            line.erase(0, line.find(space) + 1);
-            string readLine = line.substr(0, line.find(space));
-            //============================ SEARCH ID ============================= //
-            if (isdigit(readLine[0]))
-            {
-                // if first character of readLine is a digit, then we are searching for a ufid
-                ufid = readLine;
-
-                // call to searchId function in AVLTree class
-                T.searchId(ufid);
-            }
-            //============================ SEARCH NAME ============================= //
-            else
-            {   
-                line.erase(0,1);
-                // else, we are searching for a name (disregard "readLine"), set name to be the string until the next double quote is reached 
-                string name = line.substr(0,line.find("\""));
-
-                // call to searchName function in AVLTree class...
-                T.searchName(name);
-            }
-        }
-
-        //============================ PRINT COMMANDS ============================= //
-
-        else if (command == "printInorder")
-        {
-            // call to printInorder function
-            T.printInorder();
-        }
-
-        else if (command == "printPreorder")
-        {
-            // call to printPreorder function
-            T.printPreorder();
-        }
-
-        else if (command == "printPostorder")
-        {
-            // call to printPostorder function
-            T.printPostOrder();
-        }
-
-        else if (command == "printLevelCount")
-        {
-            // call to printLevelCount function
-            T.printLevelCount();
-            cout << endl;
-        }
-
-        else
-        {
-            // print "unsuccessful" for misspelled or invalid commands
-            cout << T.unsuccess << endl;
-        }
-
-    }
-
-    return 0;
-}
+#include "AVL.h"
+#include "BinaryCommands.h"
+#include "CommandPipeline.h"
+#include "CommandServer.h"
+#include "Commands.h"
+#include "LatencyHistogram.h"
+#include "PerfCounters.h"
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <map>
+using namespace std;
+
+// set by SIGUSR1; the command loop prints the latency histograms after the command in progress
+volatile sig_atomic_t latencyDumpRequested = 0;
+
+void requestLatencyDump(int)
+{
+    latencyDumpRequested = 1;
+}
+
+
+// server mode stops on SIGINT / SIGTERM after the batch in progress
+CommandServer* activeServer = nullptr;
+
+void requestServerStop(int)
+{
+    if (activeServer != nullptr)
+    {
+        activeServer->requestStop();
+    }
+}
+
+
+int main(int argc, char* argv[]) 
+{
+    AVLTree T;
+    bool trackLatency = false;
+    bool trackPerf = false;
+    size_t pipelineBatch = 0;
+    const char* servePath = nullptr;
+    bool binaryInput = false;
+    PerfCounters perf;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        // optional durability: "--wal LOGPATH SNAPSHOTPATH [GROUPCOMMITMICROS]" recovers the tree, then logs every update
+        if (strcmp(argv[arg], "--wal") == 0 && arg + 2 < argc)
+        {
+            const char* logPath = argv[++arg];
+            const char* snapshotPath = argv[++arg];
+            int groupCommitMicros = 1000;
+            if (arg + 1 < argc && isdigit((unsigned char)argv[arg + 1][0]))
+            {
+                groupCommitMicros = atoi(argv[++arg]);
+            }
+            if (!T.enableWal(logPath, snapshotPath, groupCommitMicros))
+            {
+                cerr << "could not recover from " << snapshotPath << " / " << logPath << endl;
+                return 1;
+            }
+        }
+        // optional lazy deletion: "--tombstones [THRESHOLD]" marks removed students and compacts once tombstones pass THRESHOLD of the tree
+        else if (strcmp(argv[arg], "--tombstones") == 0)
+        {
+            double threshold = 0.25;
+            if (arg + 1 < argc && (isdigit((unsigned char)argv[arg + 1][0]) || argv[arg + 1][0] == '.'))
+            {
+                threshold = atof(argv[++arg]);
+            }
+            T.enableTombstones(threshold);
+        }
+        // optional "--latency": per-command latency histograms on stderr at the end of the run, and whenever SIGUSR1 arrives
+        else if (strcmp(argv[arg], "--latency") == 0)
+        {
+            trackLatency = true;
+            signal(SIGUSR1, requestLatencyDump);
+        }
+        // optional "--perf": hardware counter deltas (cache / TLB / branch misses) per command type on stderr at the end of the run
+        else if (strcmp(argv[arg], "--perf") == 0)
+        {
+            trackPerf = perf.open();
+            if (!trackPerf)
+            {
+                cerr << "perf_event_open failed; running without hardware counters" << endl;
+            }
+        }
+        // optional "--pipeline [BATCH]": parse, execute and write output on three threads, BATCH commands at a time
+        else if (strcmp(argv[arg], "--pipeline") == 0)
+        {
+            pipelineBatch = 256;
+            if (arg + 1 < argc && isdigit((unsigned char)argv[arg + 1][0]))
+            {
+                pipelineBatch = max(1, atoi(argv[++arg]));
+            }
+        }
+        // optional "--serve SOCKETPATH": instead of reading stdin, answer command lines from local clients on a Unix socket
+        else if (strcmp(argv[arg], "--serve") == 0 && arg + 1 < argc)
+        {
+            servePath = argv[++arg];
+        }
+        // optional "--binary": stdin holds a binary command stream (see BinaryCommands.h and tools/convertCommands.cpp)
+        else if (strcmp(argv[arg], "--binary") == 0)
+        {
+            binaryInput = true;
+        }
+    }
+
+    if (binaryInput)
+    {
+        string stream((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+        if (!runBinaryCommands(T, stream.data(), stream.size()))
+        {
+            cerr << "malformed binary command stream" << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (servePath != nullptr)
+    {
+        CommandServer server(T, servePath);
+        if (!server.open())
+        {
+            cerr << "could not listen on " << servePath << ": " << strerror(errno) << endl;
+            return 1;
+        }
+        activeServer = &server;
+        signal(SIGINT, requestServerStop);
+        signal(SIGTERM, requestServerStop);
+        bool clean = server.run();
+        activeServer = nullptr;
+
+        CommandServer::Stats served = server.stats();
+        cerr << "served " << served.commands << " commands from " << served.clients << " clients in " << served.batches
+             << " batches (largest " << served.largestBatch << ")" << endl;
+        return clean ? 0 : 1;
+    }
+    LatencyRecorder latencies;
+    map<string, pair<PerfCounters::Sample, uint64_t>> perfTotals;
+
+    // read in first line and create variable for the number of commands (lineCount)
+    string line;
+    getline(cin, line);
+    int lineCount = stoi(line);
+
+    // per-command timing needs the commands one at a time on this thread, so --latency / --perf keep the plain loop
+    if (pipelineBatch != 0 && (trackLatency || trackPerf))
+    {
+        cerr << "--pipeline cannot time single commands; running without it" << endl;
+    }
+    else if (pipelineBatch != 0)
+    {
+        runPipelined(T, cin, lineCount, cout, pipelineBatch);
+        return 0;
+    }
+
+    // for each command, execute it on the AVLTree T
+    for (int i = 0; i < lineCount; ++i)
+    {
+        // read current line
+        getline(cin, line);          
+
+        // parse and execute the command on the AVLTree T
+        if (!trackLatency && !trackPerf)
+        {
+            executeCommand(T, line);
+            continue;
+        }
+        PerfCounters::Sample before = trackPerf ? perf.read() : PerfCounters::Sample();
+        uint64_t start = CycleClock::now();
+        executeCommand(T, line);
+        uint64_t ticks = CycleClock::now() - start;
+        string type = commandType(line);
+        if (trackPerf)
+        {
+            pair<PerfCounters::Sample, uint64_t>& total = perfTotals[type];
+            total.first += perf.read() - before;
+            total.second++;
+        }
+        if (trackLatency)
+        {
+            latencies.record(type, ticks);
+        }
+
+        if (latencyDumpRequested)
+        {
+            latencyDumpRequested = 0;
+            latencies.print(cerr);
+        }
+    }
+
+    if (trackLatency)
+    {
+        latencies.print(cerr);
+    }
+    if (trackPerf)
+    {
+        PerfCounters::printHeader(cerr, "command");
+        for (auto& entry : perfTotals)
+        {
+            perf.printRow(cerr, entry.first, entry.second.first, entry.second.second);
+        }
+    }
+    return 0;
+}
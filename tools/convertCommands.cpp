@@ -0,0 +1,45 @@
+#include "BinaryCommands.h"
+#include <fstream>
+using namespace std;
+
+/*
+	Converts a command file in main.cpp's text format to the binary command format of BinaryCommands.h (At the repository root):
+		g++ -std=c++14 -O2 -pthread -I. -o build/convertCommands tools/convertCommands.cpp && build/convertCommands workload.txt workload.bin
+	Run the result with "build/main --binary < workload.bin"; it prints exactly what the text file prints.
+*/
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		cerr << "usage: convertCommands TEXTFILE BINARYFILE" << endl;
+		return 1;
+	}
+	ifstream input(argv[1]);
+	if (!input)
+	{
+		cerr << "cannot open " << argv[1] << endl;
+		return 1;
+	}
+
+	string line;
+	getline(input, line);
+	long long lineCount = stoll(line);
+	string records;
+	long long converted = 0;
+	for (; converted < lineCount && getline(input, line); converted++)
+		encodeCommandLine(line, records);
+
+	string header;
+	encodeBinaryHeader((uint64_t)converted, header);
+	ofstream output(argv[2], ios::binary | ios::trunc);
+	output << header << records;
+	output.close();
+	if (!output)
+	{
+		cerr << "cannot write " << argv[2] << endl;
+		return 1;
+	}
+	cerr << converted << " commands, " << header.size() + records.size() << " bytes" << endl;
+	return 0;
+}
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+using namespace std;
+
+/*
+	Generates a command file in main.cpp's format (count line, then one command per line) for capacity planning (At the repository root):
+		g++ -std=c++14 -O2 -o build/generateWorkload tools/generateWorkload.cpp
+		build/generateWorkload --count 1000000 --mix insert=50,remove=10,searchId=30,searchName=10 --keys zipf > workload.txt
+
+	Options (defaults in brackets):
+		--count N          number of commands [100000]
+		--mix LIST         comma separated command=weight pairs over insert, remove, removeInorder, searchId, searchName,
+		                   printInorder, printPreorder, printPostorder, printLevelCount [insert=60,remove=10,removeInorder=1,searchId=20,searchName=9]
+		--keys DIST        ufid distribution: sequential, uniform or zipf [uniform]
+		--zipf S           zipf exponent [0.99]
+		--key-space N      number of distinct ufids drawn from [count]
+		--dup-names P      probability that an insert reuses a name already generated [0.1]
+		--invalid P        probability that an insert carries an invalid name or ufid [0]
+		--seed S           random seed [1]
+*/
+
+const char* commandNames[] = {"insert", "remove", "removeInorder", "searchId", "searchName", "printInorder", "printPreorder", "printPostorder", "printLevelCount"};
+const int commandCount = 9;
+
+// live ufid values in the tree's order, with find_by_order locating the n'th in O(log n) (libstdc++'s order statistic tree)
+typedef __gnu_pbds::tree<unsigned, __gnu_pbds::null_type, less<unsigned>, __gnu_pbds::rb_tree_tag,
+						 __gnu_pbds::tree_order_statistics_node_update> OrderedKeys;
+
+
+// draws ufid ranks 0 .. keySpace-1
+class KeyGenerator
+{
+	private:
+		string distribution;
+		int keySpace;
+		int next = 0;
+		vector<double> cumulative;
+
+	public:
+		KeyGenerator(const string& distribution, int keySpace, double skew) : distribution(distribution), keySpace(keySpace)
+		{
+			if (distribution == "zipf")
+			{
+				cumulative.resize(keySpace);
+				double total = 0;
+				for (int i = 0; i < keySpace; i++)
+				{
+					total += 1.0 / pow(i + 1, skew);
+					cumulative[i] = total;
+				}
+			}
+		}
+
+		int draw(mt19937_64& rng)
+		{
+			if (distribution == "sequential")
+				return next++ % keySpace;
+			if (distribution == "zipf")
+			{
+				double target = uniform_real_distribution<double>(0, cumulative.back())(rng);
+				return (int)(lower_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin());
+			}
+			return (int)(rng() % keySpace);
+		}
+};
+
+
+// sequential ranks map to consecutive ufids; otherwise ranks are scattered over the 8-digit space (bijectively mod 10^8)
+string ufidOf(int rank, const string& distribution)
+{
+	char ufid[16];
+	unsigned value = distribution == "sequential" ? (unsigned)rank : (unsigned)(((uint64_t)rank * 2654435761u) % 100000000u);
+	snprintf(ufid, sizeof(ufid), "%08u", value);
+	return ufid;
+}
+
+
+// builds a "First Last" name out of syllables
+string randomName(mt19937_64& rng)
+{
+	static const char* syllables[] = {"an", "be", "ca", "da", "el", "fi", "go", "ha", "is", "jo", "ka", "li", "mo", "na", "ol", "ra"};
+	string name;
+	for (int word = 0; word < 2; word++)
+	{
+		string part;
+		int length = 1 + (int)(rng() % 3);
+		for (int i = 0; i < length; i++)
+			part += syllables[rng() % 16];
+		part[0] = (char)toupper(part[0]);
+		name += (word == 0 ? "" : " ") + part;
+	}
+	return name;
+}
+
+
+int main(int argc, char* argv[])
+{
+	int count = 100000;
+	string mixText = "insert=60,remove=10,removeInorder=1,searchId=20,searchName=9";
+	string distribution = "uniform";
+	double skew = 0.99;
+	int keySpace = -1;
+	double duplicateNames = 0.1;
+	double invalid = 0;
+	unsigned seed = 1;
+
+	for (int i = 1; i < argc; i += 2)
+	{
+		string option = argv[i];
+		if (i + 1 == argc)
+		{
+			cerr << "option " << option << " needs a value" << endl;
+			return 1;
+		}
+		string value = argv[i + 1];
+		if (option == "--count") count = atoi(value.c_str());
+		else if (option == "--mix") mixText = value;
+		else if (option == "--keys") distribution = value;
+		else if (option == "--zipf") skew = atof(value.c_str());
+		else if (option == "--key-space") keySpace = atoi(value.c_str());
+		else if (option == "--dup-names") duplicateNames = atof(value.c_str());
+		else if (option == "--invalid") invalid = atof(value.c_str());
+		else if (option == "--seed") seed = (unsigned)atoi(value.c_str());
+		else
+		{
+			cerr << "unknown option " << option << endl;
+			return 1;
+		}
+	}
+	if (distribution != "sequential" && distribution != "uniform" && distribution != "zipf")
+	{
+		cerr << "unknown key distribution " << distribution << endl;
+		return 1;
+	}
+	if (keySpace <= 0)
+		keySpace = max(count, 1);
+
+	// parse the mix into cumulative weights
+	vector<int> cumulative(commandCount, 0);
+	stringstream mixStream(mixText);
+	string entry;
+	map<string, int> weights;
+	while (getline(mixStream, entry, ','))
+	{
+		size_t equals = entry.find('=');
+		weights[entry.substr(0, equals)] = equals == string::npos ? 1 : atoi(entry.substr(equals + 1).c_str());
+	}
+	int total = 0;
+	for (int c = 0; c < commandCount; c++)
+	{
+		total += weights.count(commandNames[c]) ? weights[commandNames[c]] : 0;
+		cumulative[c] = total;
+	}
+	if (total <= 0)
+	{
+		cerr << "the mix has no weight" << endl;
+		return 1;
+	}
+
+	mt19937_64 rng(seed);
+	KeyGenerator keys(distribution, keySpace, skew);
+	uniform_real_distribution<double> chance(0, 1);
+
+	// the generator tracks which ufids are live, in the tree's order, so removeInorder indexes and searchName targets stay
+	// realistic and each removeInorder takes out the same student the tree will
+	OrderedKeys live;
+	vector<string> names;
+
+	cout << count << "\n";
+	for (int i = 0; i < count; i++)
+	{
+		int pick = (int)(rng() % total);
+		int command = (int)(upper_bound(cumulative.begin(), cumulative.end(), pick) - cumulative.begin());
+		int rank = keys.draw(rng);
+		string ufid = ufidOf(rank, distribution);
+
+		switch (command)
+		{
+			case 0:
+			{
+				string name = !names.empty() && chance(rng) < duplicateNames ? names[rng() % names.size()] : randomName(rng);
+				if (chance(rng) < invalid)
+				{
+					// half of the invalid inserts break the name, half break the ufid
+					if (rng() % 2)
+						name += "7";
+					else
+						ufid = ufid.substr(1);
+				}
+				else
+				{
+					live.insert((unsigned)stoul(ufid));
+					names.push_back(name);
+				}
+				cout << "insert \"" << name << "\" " << ufid << "\n";
+				break;
+			}
+			case 1:
+				live.erase((unsigned)stoul(ufid));
+				cout << "remove " << ufid << "\n";
+				break;
+			case 2:
+			{
+				size_t n = live.empty() ? 0 : rng() % live.size();
+				cout << "removeInorder " << n << "\n";
+				if (!live.empty())
+					live.erase(live.find_by_order(n));
+				break;
+			}
+			case 3:
+				cout << "search " << ufid << "\n";
+				break;
+			case 4:
+				cout << "search \"" << (names.empty() ? randomName(rng) : names[rng() % names.size()]) << "\"\n";
+				break;
+			default:
+				cout << commandNames[command] << "\n";
+				break;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,85 @@
+#include "AVL.h"
+#include "Commands.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+using namespace std;
+
+/*
+	Replays a command file in main.cpp's format through the same parser and times every command by type (At the repository root):
+		g++ -std=c++14 -O2 -I. -o build/replay tools/replay.cpp && build/replay workload.txt [--echo]
+	The timing report goes to stderr; command output is discarded unless --echo sends it to stdout.
+*/
+
+// streambuf that drops everything written to it
+class NullBuffer : public streambuf
+{
+	protected:
+		int overflow(int c) override { return c; }
+		streamsize xsputn(const char*, streamsize count) override { return count; }
+};
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		cerr << "usage: replay FILE [--echo]" << endl;
+		return 1;
+	}
+	ifstream input(argv[1]);
+	if (!input)
+	{
+		cerr << "cannot open " << argv[1] << endl;
+		return 1;
+	}
+	bool echo = argc > 2 && string(argv[2]) == "--echo";
+
+	// read the whole file first so the timings cover parsing and execution, not disk reads
+	string line;
+	getline(input, line);
+	int lineCount = stoi(line);
+	vector<string> commands;
+	commands.reserve(lineCount);
+	for (int i = 0; i < lineCount && getline(input, line); i++)
+		commands.push_back(line);
+
+	NullBuffer sink;
+	streambuf* original = cout.rdbuf();
+	if (!echo)
+		cout.rdbuf(&sink);
+
+	AVLTree T;
+	map<string, vector<double>> latencies;
+	auto start = chrono::steady_clock::now();
+	for (const string& command : commands)
+	{
+		auto commandStart = chrono::steady_clock::now();
+		executeCommand(T, command);
+		double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - commandStart).count();
+		latencies[commandType(command)].push_back(micros);
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout.rdbuf(original);
+
+	cerr << fixed << setprecision(0);
+	cerr << commands.size() << " commands in " << setprecision(3) << seconds << " s (" << setprecision(0)
+		 << commands.size() / seconds << " commands/s)" << endl;
+	cerr << left << setw(18) << "command" << right << setw(10) << "count" << setw(10) << "total %" << setw(11) << "mean us"
+		 << setw(10) << "p50 us" << setw(10) << "p99 us" << setw(12) << "max us" << endl;
+	cerr << setprecision(2);
+	for (auto& entry : latencies)
+	{
+		vector<double>& sorted = entry.second;
+		sort(sorted.begin(), sorted.end());
+		double sum = 0;
+		for (double latency : sorted)
+			sum += latency;
+		cerr << left << setw(18) << entry.first << right << setw(10) << sorted.size() << setw(10) << 100 * sum / 1e6 / seconds
+			 << setw(11) << sum / sorted.size() << setw(10) << sorted[sorted.size() / 2] << setw(10)
+			 << sorted[min(sorted.size() - 1, sorted.size() * 99 / 100)] << setw(12) << sorted.back() << endl;
+	}
+	return 0;
+}